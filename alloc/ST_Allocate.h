@@ -2,53 +2,219 @@
 #define ST_ALLOCATE
 
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
+#include <mutex>
+#include "../mySTL/include/st_alloc_stats.h"
+#include "../mySTL/include/st_chunk_provider.h"
 
 namespace ST_alloc {
-	
+
 	class default_alloc {
 	private:
+		//sizes up to _MAX_SMALL are spaced by _ALIGN, above it every
+		//power of two band is split into _TIER_STEPS classes
 		enum {_ALIGN = 8};
-		enum Max_byte{_MAX_BYTE = 128};
-		enum {_NFREELISTS = _MAX_BYTE/_ALIGN};
+		enum {_MAX_SMALL = 128};
+		enum {_TIER_STEPS = 4};
+		enum Max_byte{_MAX_BYTE = 32768};
+		enum {_NSMALL = _MAX_SMALL/_ALIGN};
+		enum {_NFREELISTS = _NSMALL + 8 * _TIER_STEPS};
+		//upper bounds for the objects moved by one refill or one magazine batch
+		enum {_REFILL_OBJS = 20, _REFILL_BYTES = 16384};
+		enum {_MAGAZINE_BATCH = 32, _MAGAZINE_BYTES = 32768};
 	private:
 
 		static size_t round_up(size_t bytes);
 		static size_t freelist_index(size_t bytes);
+		static size_t class_size(size_t index);
+		static int refill_count(size_t size);
+		static size_t magazine_batch(size_t index);
 
 		union obj {
 			union obj *freelist_link;
 			char client_data[1];
 		};
+		//the depot: shared free lists and chunk, guarded by depot_lock
 		static obj *free_list[_NFREELISTS];
 		static void* refill(size_t n);
 		static char* chunk_alloc(size_t size, int &nobjs);
 		static char* start_free;
 		static char* end_free;
 		static size_t heap_size;
+		static std::mutex depot_lock;
+		//where new chunks come from
+		static const tinySTL::chunk_provider* provider;
+
+		//every chunk obtained from a provider, sorted by address
+		struct chunk_info {
+			char* begin;
+			size_t bytes;
+			size_t carved;	//objects cut out of this chunk so far
+			const tinySTL::chunk_provider* source;
+		};
+		static chunk_info* chunks;
+		static size_t nchunks;
+		static size_t chunks_cap;
+		static void register_chunk(char* begin, size_t bytes, const tinySTL::chunk_provider* source);
+		static chunk_info* find_chunk(void* ptr);
+		static void count_free(size_t* free_objs);
+
+		//per-thread cache of one size class, no lock needed
+		struct magazine {
+			obj *head;
+			size_t count;
+		};
+		//gives the thread cache back to the depot when the thread exits
+		struct cache_reaper {
+			bool armed;
+			cache_reaper() : armed(false) {}
+			~cache_reaper();
+		};
+		static thread_local magazine magazines[_NFREELISTS];
+		static thread_local cache_reaper reaper;
+
+		static void depot_fetch(magazine &mag, size_t index);
+		static void depot_spill(magazine &mag, size_t index, size_t count);
+
+		//class _NFREELISTS of the stats counts requests above _MAX_BYTE
+		static size_t stats_class_limit(size_t index);
 
 	public:
+		struct chunk_stat {
+			void* begin;
+			size_t bytes;
+			size_t live_objects;
+			size_t free_objects;
+		};
+
 		static void* allocate(size_t n);
 		static void deallocate(void* ptr, size_t n);
 		static void* reallocate(void* begin, size_t old_size, size_t new_size);
 
+		//bytes currently held from the system
+		static size_t get_heap_size();
+		//fill at most max entries of out, return the number of chunks
+		static size_t chunk_occupancy(chunk_stat* out, size_t max);
+		//free chunks without live objects, return the bytes released
+		static size_t trim();
+		//take later chunks from p, return the provider used so far;
+		//chunks already held go back to the provider they came from
+		static const tinySTL::chunk_provider& set_chunk_provider(const tinySTL::chunk_provider& p);
+		//counters, only kept up to date when ST_ALLOC_STATS is defined
+		static tinySTL::alloc_stats& stats();
+
 	};
 
-	default_alloc::obj *default_alloc::free_list[_NFREELISTS] = 
-	{0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+	default_alloc::obj *default_alloc::free_list[_NFREELISTS] = {0};
 	char* default_alloc::start_free = 0;
 	char* default_alloc::end_free = 0;
 	size_t default_alloc::heap_size = 0;
+	std::mutex default_alloc::depot_lock;
+	const tinySTL::chunk_provider* default_alloc::provider = &tinySTL::malloc_chunks();
+	default_alloc::chunk_info* default_alloc::chunks = 0;
+	size_t default_alloc::nchunks = 0;
+	size_t default_alloc::chunks_cap = 0;
+	thread_local default_alloc::magazine default_alloc::magazines[_NFREELISTS];
+	thread_local default_alloc::cache_reaper default_alloc::reaper;
 
 	size_t default_alloc::round_up(size_t bytes) {
 		return (bytes + _ALIGN - 1)& ~(_ALIGN-1);
 	}
 
 	size_t default_alloc::freelist_index(size_t bytes) {
-		return (size_t)((bytes + _ALIGN - 1) / _ALIGN - 1);
+		if(bytes <= _MAX_SMALL)
+			return (size_t)((bytes + _ALIGN - 1) / _ALIGN - 1);
+
+		size_t band = 0;
+		while(((size_t)_MAX_SMALL << (band + 1)) < bytes)
+			++band;
+		size_t base = (size_t)_MAX_SMALL << band;
+		size_t step = base / _TIER_STEPS;
+		return _NSMALL + band * _TIER_STEPS + (bytes - base + step - 1) / step - 1;
+	}
+
+	size_t default_alloc::class_size(size_t index) {
+		if(index < _NSMALL)
+			return (index + 1) * _ALIGN;
+
+		size_t band = (index - _NSMALL) / _TIER_STEPS;
+		size_t base = (size_t)_MAX_SMALL << band;
+		return base + ((index - _NSMALL) % _TIER_STEPS + 1) * (base / _TIER_STEPS);
+	}
+
+	//small objects come 20 at a time, medium ones about 16K worth but at least 2
+	int default_alloc::refill_count(size_t size) {
+		size_t n = _REFILL_BYTES / size;
+		if(n > _REFILL_OBJS) n = _REFILL_OBJS;
+		if(n < 2) n = 2;
+		return (int)n;
+	}
+
+	//keeps a thread from parking more than about 64K of one class
+	size_t default_alloc::magazine_batch(size_t index) {
+		if(index < _NSMALL) return _MAGAZINE_BATCH;
+		size_t n = _MAGAZINE_BYTES / class_size(index);
+		if(n > _MAGAZINE_BATCH) n = _MAGAZINE_BATCH;
+		if(n < 2) n = 2;
+		return n;
 	}
 
+	//called with depot_lock held
+	void default_alloc::register_chunk(char* begin, size_t bytes, const tinySTL::chunk_provider* source) {
+		if(nchunks == chunks_cap) {
+			size_t new_cap = chunks_cap == 0 ? 16 : 2 * chunks_cap;
+			chunk_info* tmp = (chunk_info*)realloc(chunks, new_cap * sizeof(chunk_info));
+			if(!tmp) {
+				std::cerr<<"out of memory! "<<std::endl;
+				exit(1);
+			}
+			chunks = tmp;
+			chunks_cap = new_cap;
+		}
+		size_t pos = nchunks;
+		while(pos > 0 && chunks[pos - 1].begin > begin)
+			--pos;
+		memmove(chunks + pos + 1, chunks + pos, (nchunks - pos) * sizeof(chunk_info));
+		chunks[pos].begin = begin;
+		chunks[pos].bytes = bytes;
+		chunks[pos].carved = 0;
+		chunks[pos].source = source;
+		++nchunks;
+	}
+
+	//called with depot_lock held
+	default_alloc::chunk_info* default_alloc::find_chunk(void* ptr) {
+		char* p = (char*)ptr;
+		size_t lo = 0, hi = nchunks;
+		while(lo < hi) {
+			size_t mid = (lo + hi) / 2;
+			if(p < chunks[mid].begin)
+				hi = mid;
+			else if(p >= chunks[mid].begin + chunks[mid].bytes)
+				lo = mid + 1;
+			else
+				return chunks + mid;
+		}
+		return 0;
+	}
+
+	//called with depot_lock held, free_objs has nchunks entries
+	void default_alloc::count_free(size_t* free_objs) {
+		memset(free_objs, 0, nchunks * sizeof(size_t));
+		for(size_t i = 0; i < _NFREELISTS; ++i) {
+			for(obj* p = free_list[i]; p; p = p->freelist_link) {
+				chunk_info* c = find_chunk(p);
+				if(c) ++free_objs[c - chunks];
+			}
+		}
+	}
+
+	//called with depot_lock held
 	char* default_alloc::chunk_alloc(size_t size, int& nobjs) {
+#ifdef ST_ALLOC_STATS
+		stats().record_chunk_alloc();
+#endif
 		char* result;
 		size_t tot_bytes = size * nobjs;
 		size_t left_bytes = end_free - start_free;
@@ -56,6 +222,7 @@ namespace ST_alloc {
 		if(left_bytes >= tot_bytes) {
 			result = start_free;
 			start_free += tot_bytes;
+			find_chunk(result)->carved += nobjs;
 
 			return result;
 		} else if(left_bytes >= size) {
@@ -63,26 +230,33 @@ namespace ST_alloc {
 			nobjs = left_bytes / size;
 			tot_bytes = nobjs * size;
 			start_free += tot_bytes;
+			find_chunk(result)->carved += nobjs;
 
 			return result;
 		} else {
 			size_t size_to_get = 2 * tot_bytes + round_up(heap_size >> 4);
-			if(left_bytes > 0) {
-				obj **my_free_list = free_list + freelist_index(left_bytes);
+			if(left_bytes >= _ALIGN) {
+				//the tail may fall between two classes, keep it in the smaller one
+				size_t index = freelist_index(left_bytes);
+				if(class_size(index) > left_bytes) --index;
+				obj **my_free_list = free_list + index;
 				((obj *)start_free)->freelist_link = *my_free_list;
 				*my_free_list = (obj*)start_free;
+				find_chunk(start_free)->carved += 1;
 			}
 
-			start_free = (char*)malloc(size_to_get);
+			size_to_get = tinySTL::round_to_granularity(*provider, size_to_get);
+			start_free = (char*)provider->acquire(size_to_get);
 			if(!start_free) {
 				obj *p, **my_free_list;
-				for(int i = 0; i < _MAX_BYTE; i += _ALIGN) {
-					my_free_list = free_list + freelist_index(i);
+				for(size_t i = freelist_index(size); i < _NFREELISTS; ++i) {
+					my_free_list = free_list + i;
 					p = *my_free_list;
 					if(p) {
 						*my_free_list = p->freelist_link;
+						find_chunk(p)->carved -= 1;
 						start_free = (char*)p;
-						end_free = start_free + i;
+						end_free = start_free + class_size(i);
 						return chunk_alloc(size, nobjs);
 					}
 				}
@@ -91,14 +265,22 @@ namespace ST_alloc {
 				exit(1);
 			}
 			heap_size += size_to_get;
+#ifdef ST_ALLOC_STATS
+			stats().record_reserve(size_to_get);
+#endif
 			end_free = start_free + size_to_get;
+			register_chunk(start_free, size_to_get, provider);
 			return chunk_alloc(size, nobjs);
 
 		}
 	}
 
+	//called with depot_lock held
 	void* default_alloc::refill(size_t n) {
-		int nobjs = 20;
+#ifdef ST_ALLOC_STATS
+		stats().record_refill();
+#endif
+		int nobjs = refill_count(n);
 		char* chunk = chunk_alloc(n, nobjs);
 
 		if(nobjs == 1) return (obj*)chunk;
@@ -124,40 +306,202 @@ namespace ST_alloc {
 		return result;
 	}
 
-	void *default_alloc::allocate(size_t bytes) {
-		if(bytes >= _MAX_BYTE) {
-			return malloc(bytes);
+	//move up to one batch of objects from the depot into an empty magazine
+	void default_alloc::depot_fetch(magazine &mag, size_t index) {
+		reaper.armed = true;
+		size_t batch = magazine_batch(index);
+		std::lock_guard<std::mutex> guard(depot_lock);
+
+		obj **my_free_list = free_list + index;
+		if(!*my_free_list) {
+			obj *first = (obj*)refill(class_size(index));
+			first->freelist_link = *my_free_list;
+			*my_free_list = first;
 		}
 
-		obj **my_free_list;
-		obj *result;
-		my_free_list = free_list + freelist_index(bytes);
-		result = *my_free_list;
+		obj *head = *my_free_list;
+		obj *tail = head;
+		size_t count = 1;
+		while(count < batch && tail->freelist_link) {
+			tail = tail->freelist_link;
+			++count;
+		}
+		*my_free_list = tail->freelist_link;
+		tail->freelist_link = mag.head;
+		mag.head = head;
+		mag.count += count;
+	}
+
+	//hand the first count objects of a magazine back to the depot
+	void default_alloc::depot_spill(magazine &mag, size_t index, size_t count) {
+		if(count == 0) return;
 
-		if(!result) {
-			return (refill(round_up(bytes)));
+		obj *head = mag.head;
+		obj *tail = head;
+		for(size_t i = 1; i < count; ++i)
+			tail = tail->freelist_link;
+		mag.head = tail->freelist_link;
+		mag.count -= count;
+
+		std::lock_guard<std::mutex> guard(depot_lock);
+		obj **my_free_list = free_list + index;
+		tail->freelist_link = *my_free_list;
+		*my_free_list = head;
+	}
+
+	size_t default_alloc::get_heap_size() {
+		std::lock_guard<std::mutex> guard(depot_lock);
+		return heap_size;
+	}
+
+	size_t default_alloc::chunk_occupancy(chunk_stat* out, size_t max) {
+		std::lock_guard<std::mutex> guard(depot_lock);
+		size_t* free_objs = (size_t*)malloc(nchunks * sizeof(size_t) + 1);
+		if(!free_objs) return nchunks;
+		count_free(free_objs);
+		for(size_t i = 0; i < nchunks && i < max; ++i) {
+			out[i].begin = chunks[i].begin;
+			out[i].bytes = chunks[i].bytes;
+			out[i].live_objects = chunks[i].carved - free_objs[i];
+			out[i].free_objects = free_objs[i];
 		}
+		size_t n = nchunks;
+		free(free_objs);
+		return n;
+	}
+
+	//objects cached by other threads count as live, so only the calling
+	//thread's magazines are flushed before looking for empty chunks
+	size_t default_alloc::trim() {
+		for(size_t i = 0; i < _NFREELISTS; ++i)
+			depot_spill(magazines[i], i, magazines[i].count);
+
+		std::lock_guard<std::mutex> guard(depot_lock);
+		size_t* free_objs = (size_t*)malloc(nchunks * sizeof(size_t) + 1);
+		if(!free_objs) return 0;
+		count_free(free_objs);
 
-		*my_free_list = result->freelist_link;
+		//mark the chunks without live objects
+		const size_t unused = (size_t)-1;
+		size_t released = 0;
+		for(size_t i = 0; i < nchunks; ++i) {
+			if(free_objs[i] == chunks[i].carved) {
+				released += chunks[i].bytes;
+				free_objs[i] = unused;
+			}
+		}
+		if(released == 0) {
+			free(free_objs);
+			return 0;
+		}
+
+		//unlink the free objects living in released chunks
+		for(size_t i = 0; i < _NFREELISTS; ++i) {
+			obj** link = free_list + i;
+			while(*link) {
+				chunk_info* c = find_chunk(*link);
+				if(c && free_objs[c - chunks] == unused)
+					*link = (*link)->freelist_link;
+				else
+					link = &(*link)->freelist_link;
+			}
+		}
+
+		size_t kept = 0;
+		for(size_t i = 0; i < nchunks; ++i) {
+			if(free_objs[i] == unused) {
+				if(start_free >= chunks[i].begin && start_free < chunks[i].begin + chunks[i].bytes)
+					start_free = end_free = 0;
+				chunks[i].source->release(chunks[i].begin, chunks[i].bytes);
+			} else {
+				chunks[kept++] = chunks[i];
+			}
+		}
+		nchunks = kept;
+		heap_size -= released;
+#ifdef ST_ALLOC_STATS
+		stats().record_release(released);
+#endif
+		free(free_objs);
+		return released;
+	}
+
+	const tinySTL::chunk_provider& default_alloc::set_chunk_provider(const tinySTL::chunk_provider& p) {
+		std::lock_guard<std::mutex> guard(depot_lock);
+		const tinySTL::chunk_provider* old = provider;
+		provider = &p;
+		return *old;
+	}
+
+	size_t default_alloc::stats_class_limit(size_t index) {
+		return index < _NFREELISTS ? class_size(index) : 0;
+	}
+
+	tinySTL::alloc_stats& default_alloc::stats() {
+		static tinySTL::alloc_stats instance("default_alloc", _NFREELISTS + 1, stats_class_limit);
+		return instance;
+	}
+
+	default_alloc::cache_reaper::~cache_reaper() {
+		if(!armed) return;
+		for(size_t i = 0; i < _NFREELISTS; ++i)
+			depot_spill(magazines[i], i, magazines[i].count);
+	}
+
+	inline void *default_alloc::allocate(size_t bytes) {
+		if(bytes > _MAX_BYTE) {
+#ifdef ST_ALLOC_STATS
+			stats().record_alloc(_NFREELISTS, bytes, bytes);
+#endif
+			return malloc(bytes);
+		}
+		if(bytes == 0) bytes = 1;
+
+		size_t index = bytes <= _MAX_SMALL ? (bytes + _ALIGN - 1) / _ALIGN - 1 : freelist_index(bytes);
+#ifdef ST_ALLOC_STATS
+		stats().record_alloc(index, bytes, class_size(index));
+#endif
+		magazine &mag = magazines[index];
+		if(!mag.head) {
+			depot_fetch(mag, index);
+		}
+
+		obj *result = mag.head;
+		mag.head = result->freelist_link;
+		--mag.count;
 		return result;
 	}
 
 	void *default_alloc::reallocate(void *ptr, size_t old_size, size_t new_size) {
+		void *result = allocate(new_size);
+		memcpy(result, ptr, old_size < new_size ? old_size : new_size);
 		deallocate(ptr, old_size);
-		return allocate(new_size);
+		return result;
 	}
 
-	void default_alloc::deallocate(void *ptr, size_t n) {
-		if(n >= _MAX_BYTE)
+	inline void default_alloc::deallocate(void *ptr, size_t n) {
+		if(n > _MAX_BYTE) {
+#ifdef ST_ALLOC_STATS
+			stats().record_dealloc(_NFREELISTS, n, n);
+#endif
 			free(ptr);
+			return;
+		}
+		if(n == 0) n = 1;
 
-		obj **my_free_list;
-		obj *tmp_obj;
-		my_free_list = free_list + freelist_index(n);
-		tmp_obj = (obj*)ptr;
+		size_t index = n <= _MAX_SMALL ? (n + _ALIGN - 1) / _ALIGN - 1 : freelist_index(n);
+#ifdef ST_ALLOC_STATS
+		stats().record_dealloc(index, n, class_size(index));
+#endif
+		magazine &mag = magazines[index];
+		obj *tmp_obj = (obj*)ptr;
+		tmp_obj->freelist_link = mag.head;
+		mag.head = tmp_obj;
 
-		tmp_obj->freelist_link = *my_free_list;
-		*my_free_list = tmp_obj;
+		if(++mag.count == 1)
+			reaper.armed = true;
+		else if(mag.count >= 2 * magazine_batch(index))
+			depot_spill(mag, index, magazine_batch(index));
 	}
-} 
-#endif
\ No newline at end of file
+}
+#endif
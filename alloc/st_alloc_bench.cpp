@@ -0,0 +1,64 @@
+#include "ST_Allocate.h"
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//alloc/free throughput of default_alloc against malloc, 8 ~ 128 bytes
+
+enum {BATCH = 64, ROUNDS = 20000};
+
+struct pool_policy {
+	static void* allocate(size_t n) { return ST_alloc::default_alloc::allocate(n); }
+	static void deallocate(void* p, size_t n) { ST_alloc::default_alloc::deallocate(p, n); }
+};
+
+struct malloc_policy {
+	static void* allocate(size_t n) { return malloc(n); }
+	static void deallocate(void* p, size_t) { free(p); }
+};
+
+template <class Policy>
+static void worker(size_t bytes) {
+	void* objs[BATCH];
+	for(int r = 0; r < ROUNDS; ++r) {
+		for(int i = 0; i < BATCH; ++i) {
+			objs[i] = Policy::allocate(bytes);
+			*(volatile char*)objs[i] = (char)i;
+		}
+		for(int i = 0; i < BATCH; ++i)
+			Policy::deallocate(objs[i], bytes);
+	}
+}
+
+template <class Policy>
+static double run(int nthreads, size_t bytes) {
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	vector<thread> threads;
+	for(int i = 0; i < nthreads; ++i)
+		threads.push_back(thread(worker<Policy>, bytes));
+	for(int i = 0; i < nthreads; ++i)
+		threads[i].join();
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+	return 2.0 * BATCH * ROUNDS * nthreads / sec / 1e6;
+}
+
+int main(int argc, char** argv) {
+	int max_threads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+	if(max_threads < 1) max_threads = 1;
+	const size_t sizes[] = {8, 16, 32, 64, 127};
+
+	printf("%8s %6s %16s %16s\n", "threads", "bytes", "default_alloc", "malloc");
+	for(int t = 1; t <= max_threads; t *= 2) {
+		for(size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); ++k) {
+			size_t bytes = sizes[k];
+			double pool = run<pool_policy>(t, bytes);
+			double sys = run<malloc_policy>(t, bytes);
+			printf("%8d %6zu %11.1f Mop/s %11.1f Mop/s\n", t, bytes, pool, sys);
+		}
+	}
+	return 0;
+}
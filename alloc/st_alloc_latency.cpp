@@ -0,0 +1,71 @@
+#include "ST_Allocate.h"
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//allocation latency of 128B ~ 16K objects: malloc (what default_alloc
+//forwarded these sizes to before the medium classes) against the pool
+
+enum {LIVE = 256, ROUNDS = 400};
+enum {NBUCKETS = 8};
+static const double bucket_ns[NBUCKETS] = {25, 50, 100, 200, 400, 800, 1600, 1e30};
+
+struct pool_policy {
+	static const char* name() { return "default_alloc"; }
+	static void* allocate(size_t n) { return ST_alloc::default_alloc::allocate(n); }
+	static void deallocate(void* p, size_t n) { ST_alloc::default_alloc::deallocate(p, n); }
+};
+
+struct malloc_policy {
+	static const char* name() { return "malloc"; }
+	static void* allocate(size_t n) { return malloc(n); }
+	static void deallocate(void* p, size_t) { free(p); }
+};
+
+template <class Policy>
+static void run(size_t bytes) {
+	vector<double> samples;
+	samples.reserve(LIVE * ROUNDS);
+	vector<void*> objs(LIVE);
+	mt19937 rng(1);
+	for(int r = 0; r < ROUNDS; ++r) {
+		for(int i = 0; i < LIVE; ++i) {
+			chrono::steady_clock::time_point t0 = chrono::steady_clock::now();
+			objs[i] = Policy::allocate(bytes);
+			chrono::steady_clock::time_point t1 = chrono::steady_clock::now();
+			*(volatile char*)objs[i] = 1;
+			samples.push_back(chrono::duration<double, nano>(t1 - t0).count());
+		}
+		shuffle(objs.begin(), objs.end(), rng);
+		for(int i = 0; i < LIVE; ++i)
+			Policy::deallocate(objs[i], bytes);
+	}
+
+	size_t hist[NBUCKETS] = {0};
+	for(size_t i = 0; i < samples.size(); ++i) {
+		size_t b = 0;
+		while(samples[i] >= bucket_ns[b]) ++b;
+		++hist[b];
+	}
+	sort(samples.begin(), samples.end());
+	size_t n = samples.size();
+	printf("%6zu %-14s p50 %6.0f p99 %7.0f p99.9 %7.0f |", bytes, Policy::name(),
+			samples[n / 2], samples[n * 99 / 100], samples[n * 999 / 1000]);
+	for(size_t b = 0; b < NBUCKETS; ++b)
+		printf(" %5.1f", 100.0 * hist[b] / n);
+	printf("\n");
+}
+
+int main() {
+	printf("latency in ns; histogram columns are %% of calls below 25/50/100/200/400/800/1600/inf ns\n");
+	for(size_t bytes = 128; bytes <= 16384; bytes *= 2) {
+		run<malloc_policy>(bytes);
+		run<pool_policy>(bytes);
+	}
+	return 0;
+}
@@ -0,0 +1,140 @@
+#include "ST_Allocate.h"
+#include "tinySTL_alloc.h"
+#include "../mySTL/include/st_allocator.h"
+#include "../mySTL/include/st_alloc_trace.h"
+#include <vector>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+using namespace std;
+
+//replays an allocation trace recorded with ST_ALLOC_TRACE against every
+//allocator, each in its own process, and reports throughput, peak RSS
+//growth and how much of it live blocks did not account for.
+//The trace is replayed on one thread in recorded order.
+
+struct simple_policy {
+	static const char* name() { return "SimpleAlloc"; }
+	static void* allocate(size_t n) { return tinySTL::SimpleAlloc::allocate(n); }
+	static void deallocate(void* p, size_t) { tinySTL::SimpleAlloc::deallocate(p); }
+	static void* reallocate(void* p, size_t, size_t n) { return tinySTL::SimpleAlloc::reallocate(p, n); }
+};
+
+struct pool_policy {
+	static const char* name() { return "default_alloc"; }
+	static void* allocate(size_t n) { return ST_alloc::default_alloc::allocate(n); }
+	static void deallocate(void* p, size_t n) { ST_alloc::default_alloc::deallocate(p, n); }
+	static void* reallocate(void* p, size_t old_n, size_t n) {
+		return ST_alloc::default_alloc::reallocate(p, old_n, n);
+	}
+};
+
+struct malloc_policy {
+	static const char* name() { return "_malloc_alloc"; }
+	static void* allocate(size_t n) { return tinySTL::_malloc_alloc<0>::allocate(n); }
+	static void deallocate(void* p, size_t) { tinySTL::_malloc_alloc<0>::deallocate(p); }
+	static void* reallocate(void* p, size_t, size_t n) { return tinySTL::_malloc_alloc<0>::reallocate(p, n); }
+};
+
+//write one byte per page so the block counts toward RSS
+static void touch(void* p, size_t n) {
+	for(size_t i = 0; i < n; i += 4096)
+		((volatile char*)p)[i] = 1;
+}
+
+static long max_rss_kb() {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+template <class Policy>
+static void replay(const vector<tinySTL::trace_record>& trace, uint32_t nids, size_t peak_live) {
+	vector<void*> blocks(nids, (void*)0);
+	vector<size_t> sizes(nids, 0);
+	long base_rss = max_rss_kb();
+
+	chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+	for(size_t i = 0; i < trace.size(); ++i) {
+		const tinySTL::trace_record& r = trace[i];
+		switch(r.op) {
+		case tinySTL::TRACE_ALLOC:
+			blocks[r.id] = Policy::allocate(r.size);
+			sizes[r.id] = r.size;
+			touch(blocks[r.id], r.size);
+			break;
+		case tinySTL::TRACE_FREE:
+			if(blocks[r.id]) Policy::deallocate(blocks[r.id], sizes[r.id]);
+			blocks[r.id] = 0;
+			break;
+		case tinySTL::TRACE_REALLOC:
+			if(blocks[r.id])
+				blocks[r.id] = Policy::reallocate(blocks[r.id], sizes[r.id], r.size);
+			else
+				blocks[r.id] = Policy::allocate(r.size);
+			sizes[r.id] = r.size;
+			touch(blocks[r.id], r.size);
+			break;
+		}
+	}
+	double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+	long rss = max_rss_kb() - base_rss;
+	double overhead = rss > 0 ? 1.0 - (double)peak_live / 1024 / rss : 0;
+	if(overhead < 0) overhead = 0;
+	printf("%14s %10.2f Mop/s %10ld kB %9.1f %%\n", Policy::name(), trace.size() / sec / 1e6, rss, 100 * overhead);
+}
+
+template <class Policy>
+static void run(const vector<tinySTL::trace_record>& trace, uint32_t nids, size_t peak_live) {
+	fflush(stdout);
+	pid_t pid = fork();
+	if(pid == 0) {
+		replay<Policy>(trace, nids, peak_live);
+		exit(0);
+	}
+	waitpid(pid, 0, 0);
+}
+
+int main(int argc, char** argv) {
+	if(argc < 2) {
+		fprintf(stderr, "usage: %s trace-file\n", argv[0]);
+		return 1;
+	}
+	FILE* f = fopen(argv[1], "rb");
+	if(!f || !tinySTL::read_trace_header(f)) {
+		fprintf(stderr, "%s is not an allocation trace\n", argv[1]);
+		return 1;
+	}
+	vector<tinySTL::trace_record> trace;
+	tinySTL::trace_record r;
+	while(fread(&r, sizeof(r), 1, f) == 1)
+		trace.push_back(r);
+	fclose(f);
+
+	//the live bytes of the trace itself, the floor for any allocator
+	uint32_t nids = 0;
+	vector<size_t> sizes;
+	size_t live = 0, peak_live = 0;
+	for(size_t i = 0; i < trace.size(); ++i) {
+		if(trace[i].id >= nids) {
+			nids = trace[i].id + 1;
+			sizes.resize(nids, 0);
+		}
+		live -= sizes[trace[i].id];
+		sizes[trace[i].id] = trace[i].op == tinySTL::TRACE_FREE ? 0 : trace[i].size;
+		live += sizes[trace[i].id];
+		if(live > peak_live) peak_live = live;
+	}
+	printf("%zu events, %u block ids, peak live %zu kB\n", trace.size(), nids, peak_live / 1024);
+	printf("%14s %16s %13s %11s\n", "allocator", "throughput", "peak RSS", "overhead");
+
+	run<simple_policy>(trace, nids, peak_live);
+	run<pool_policy>(trace, nids, peak_live);
+	run<malloc_policy>(trace, nids, peak_live);
+	return 0;
+}
@@ -0,0 +1,82 @@
+#define ST_ALLOC_STATS
+#include "ST_Allocate.h"
+#include "tinySTL_alloc.h"
+#include "../mySTL/include/st_allocator.h"
+#include <assert.h>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+//counters of default_alloc, SimpleAlloc and _malloc_alloc after a known
+//sequence of requests
+
+static void pool_counts() {
+	tinySTL::alloc_stats_snapshot s;
+	void* small[10];
+	for(int i = 0; i < 10; ++i)
+		small[i] = ST_alloc::default_alloc::allocate(13);
+	void* medium = ST_alloc::default_alloc::allocate(150);
+	void* large = ST_alloc::default_alloc::allocate(40000);
+
+	ST_alloc::default_alloc::stats().snapshot(s);
+	assert(s.enabled);
+	assert(s.allocs[1] == 10 && s.deallocs[1] == 0 && s.class_limit[1] == 16);
+	assert(s.class_limit[16] == 160 && s.allocs[16] == 1);
+	assert(s.class_limit[s.nclasses - 1] == 0 && s.allocs[s.nclasses - 1] == 1);
+	assert(s.requested_in_use == 10 * 13 + 150 + 40000);
+	assert(s.bytes_in_use == 10 * 16 + 160 + 40000);
+	assert(s.internal_fragmentation() == 10 * 3 + 10);
+	assert(s.refills >= 2 && s.chunk_allocs >= 2);
+	assert(s.reserved_bytes == ST_alloc::default_alloc::get_heap_size());
+
+	for(int i = 0; i < 10; ++i)
+		ST_alloc::default_alloc::deallocate(small[i], 13);
+	ST_alloc::default_alloc::deallocate(medium, 150);
+	ST_alloc::default_alloc::deallocate(large, 40000);
+
+	ST_alloc::default_alloc::stats().snapshot(s);
+	assert(s.bytes_in_use == 0 && s.requested_in_use == 0);
+	assert(s.high_water == 10 * 16 + 160 + 40000);
+	assert(s.deallocs[1] == 10);
+}
+
+static void malloc_counts() {
+	tinySTL::alloc_stats_snapshot s;
+	void* p = tinySTL::SimpleAlloc::allocate(100);
+	p = tinySTL::SimpleAlloc::reallocate(p, 1000);
+	tinySTL::SimpleAlloc::stats().snapshot(s);
+	assert(s.bytes_in_use == 1000 && s.high_water == 1000);
+	assert(s.allocs[tinySTL::alloc_stats::pow2_class(100)] == 1);
+	assert(s.deallocs[tinySTL::alloc_stats::pow2_class(100)] == 1);
+	assert(s.class_limit[tinySTL::alloc_stats::pow2_class(1000)] == 1024);
+	tinySTL::SimpleAlloc::deallocate(p);
+	tinySTL::SimpleAlloc::stats().snapshot(s);
+	assert(s.bytes_in_use == 0);
+
+	typedef tinySTL::_malloc_alloc<0> malloc_alloc;
+	p = malloc_alloc::allocate(64);
+	malloc_alloc::stats().snapshot(s);
+	assert(s.bytes_in_use == 64 && s.allocs[3] == 1);
+	malloc_alloc::deallocate(p);
+	malloc_alloc::stats().snapshot(s);
+	assert(s.bytes_in_use == 0 && s.deallocs[3] == 1);
+}
+
+static void dumps() {
+	ostringstream text, json;
+	tinySTL::alloc_stats::dump_all(text, false);
+	tinySTL::alloc_stats::dump_all(json, true);
+	assert(text.str().find("default_alloc:") != string::npos);
+	assert(text.str().find("SimpleAlloc:") != string::npos);
+	assert(json.str()[0] == '[');
+	assert(json.str().find("\"name\":\"_malloc_alloc\"") != string::npos);
+	cout << json.str();
+}
+
+int main() {
+	pool_counts();
+	malloc_counts();
+	dumps();
+	return 0;
+}
@@ -1,9 +1,86 @@
 #include "ST_Allocate.h"
 #include <vector>
+#include <thread>
+#include <assert.h>
 #include <iostream>
 
 using namespace std;
 
+//every thread allocates, stamps, checks and frees objects of all small sizes
+static void churn(int id) {
+	vector<char*> objs;
+	for(int round = 0; round < 200; ++round) {
+		for(size_t n = 1; n < 128; n += 7) {
+			char* p = (char*)ST_alloc::default_alloc::allocate(n);
+			for(size_t i = 0; i < n; ++i) p[i] = (char)(id + n);
+			objs.push_back(p);
+		}
+		for(size_t k = 0, n = 1; n < 128; n += 7, ++k) {
+			char* p = objs[k];
+			for(size_t i = 0; i < n; ++i) assert(p[i] == (char)(id + n));
+			ST_alloc::default_alloc::deallocate(p, n);
+		}
+		objs.clear();
+		for(size_t n = 100; n <= 40000; n = n * 3 / 2) {
+			char* p = (char*)ST_alloc::default_alloc::allocate(n);
+			p[0] = p[n - 1] = (char)id;
+			objs.push_back(p);
+		}
+		for(size_t k = 0, n = 100; n <= 40000; n = n * 3 / 2, ++k) {
+			char* p = objs[k];
+			assert(p[0] == (char)id && p[n - 1] == (char)id);
+			ST_alloc::default_alloc::deallocate(p, n);
+		}
+		objs.clear();
+	}
+}
+
+//a burst of allocations is handed back to the system once it is all freed
+static void burst_and_trim() {
+	vector<void*> objs;
+	for(int i = 0; i < 100000; ++i)
+		objs.push_back(ST_alloc::default_alloc::allocate(48));
+	size_t peak = ST_alloc::default_alloc::get_heap_size();
+	assert(peak >= 48 * objs.size());
+
+	ST_alloc::default_alloc::chunk_stat stats[64];
+	size_t n = ST_alloc::default_alloc::chunk_occupancy(stats, 64);
+	size_t live = 0;
+	for(size_t i = 0; i < n && i < 64; ++i)
+		live += stats[i].live_objects;
+	assert(n > 64 || live >= objs.size());
+
+	for(size_t i = 0; i < objs.size(); ++i)
+		ST_alloc::default_alloc::deallocate(objs[i], 48);
+	size_t released = ST_alloc::default_alloc::trim();
+	assert(released > 0);
+	assert(ST_alloc::default_alloc::get_heap_size() == peak - released);
+	cout<<"trim released "<<released<<" of "<<peak<<" bytes"<<endl;
+
+	//the pool still works after a trim
+	void* p = ST_alloc::default_alloc::allocate(48);
+	ST_alloc::default_alloc::deallocate(p, 48);
+}
+
+//the same burst with chunks mapped from the huge page provider
+static void mmap_chunks() {
+	ST_alloc::default_alloc::set_chunk_provider(tinySTL::mmap_chunks());
+	void* p = ST_alloc::default_alloc::allocate(4000);
+	ST_alloc::default_alloc::chunk_stat stats[64];
+	size_t n = ST_alloc::default_alloc::chunk_occupancy(stats, 64);
+	size_t mapped = 0;
+	for(size_t i = 0; i < n && i < 64; ++i) {
+		if((size_t)stats[i].begin % tinySTL::mmap_chunks().granularity == 0
+				&& stats[i].bytes % tinySTL::mmap_chunks().granularity == 0)
+			++mapped;
+	}
+	assert(mapped > 0);
+	ST_alloc::default_alloc::deallocate(p, 4000);
+
+	burst_and_trim();
+	ST_alloc::default_alloc::set_chunk_provider(tinySTL::malloc_chunks());
+}
+
 int main() {
 	int a[5] = {1,2,3,4,5};
 
@@ -15,5 +92,15 @@ int main() {
 	}
 	cout<<endl;
 
+	vector<thread> workers;
+	for(int i = 0; i < 8; ++i)
+		workers.push_back(thread(churn, i));
+	for(size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+	cout<<"default_alloc threads ok"<<endl;
+
+	burst_and_trim();
+	mmap_chunks();
+
 	return 0;
-}
\ No newline at end of file
+}
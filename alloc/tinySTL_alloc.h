@@ -1,4 +1,8 @@
+#ifndef TINYSTL_ALLOC_H
+#define TINYSTL_ALLOC_H
 #include <cstdlib>
+#include <iostream>
+#include "../mySTL/include/st_alloc_stats.h"
 
 namespace tinySTL {
 
@@ -8,25 +12,103 @@ template <int inst>
 		static void *oom_malloc(size_t);
 		static void *oom_realloc(void *, size_t);
 		static void (* malloc_alloc_oom_handler)();
+#ifdef ST_ALLOC_STATS
+		//with stats on every block carries its size in front
+		enum {_STATS_HEADER = 16};
+#endif
 	public:
 		static void *allocate(size_t n) {
+#ifdef ST_ALLOC_STATS
+			void *result = malloc(n + _STATS_HEADER);
+			if(!result) {
+				result = oom_malloc(n + _STATS_HEADER);
+			}
+			*(size_t*)result = n;
+			stats().record_alloc(alloc_stats::pow2_class(n), n, n);
+			return (char*)result + _STATS_HEADER;
+#else
 			void *result = malloc(n);
 			if(!result) {
 				result = oom_malloc(n);
 			}
 			return result;
+#endif
 		}
 
 		static void *reallocate(void *old, size_t n) {
-			void *result = realloc(old, n);
-			if(!result) {
-				result = oom_realloc(old, n);
-			}
-			return result;
+#ifdef ST_ALLOC_STATS
+			if(!old) return allocate(n);
+			old = (char*)old - _STATS_HEADER;
+			size_t old_size = *(size_t*)old;
+			void *result = oom_realloc(old, n + _STATS_HEADER);
+			*(size_t*)result = n;
+			stats().record_dealloc(alloc_stats::pow2_class(old_size), old_size, old_size);
+			stats().record_alloc(alloc_stats::pow2_class(n), n, n);
+			return (char*)result + _STATS_HEADER;
+#else
+			return oom_realloc(old, n);
+#endif
 		}
 
 		static void deallocate(void *p) {
+#ifdef ST_ALLOC_STATS
+			if(!p) return;
+			p = (char*)p - _STATS_HEADER;
+			size_t n = *(size_t*)p;
+			stats().record_dealloc(alloc_stats::pow2_class(n), n, n);
+#endif
 			free(p);
 		}
+
+		//returns the previous handler
+		static void (* set_malloc_handler(void (*f)()))() {
+			void (* old)() = malloc_alloc_oom_handler;
+			malloc_alloc_oom_handler = f;
+			return old;
+		}
+
+		static alloc_stats& stats() {
+			static alloc_stats instance("_malloc_alloc", alloc_stats::POW2_CLASSES, alloc_stats::pow2_limit);
+			return instance;
+		}
 	};
-}
\ No newline at end of file
+
+template <int inst>
+	void (* _malloc_alloc<inst>::malloc_alloc_oom_handler)() = 0;
+
+	//keep calling the handler until malloc succeeds
+template <int inst>
+	void *_malloc_alloc<inst>::oom_malloc(size_t n) {
+		void (* handler)();
+		void *result;
+		for(;;) {
+			handler = malloc_alloc_oom_handler;
+			if(!handler) {
+				std::cerr<<"out of memory!"<<std::endl;
+				exit(1);
+			}
+			(*handler)();
+			result = malloc(n);
+			if(result) return result;
+		}
+	}
+
+	//realloc, calling the handler between attempts; p is only passed
+	//again after a realloc that failed and so left it valid
+template <int inst>
+	void *_malloc_alloc<inst>::oom_realloc(void *p, size_t n) {
+		void (* handler)();
+		void *result;
+		for(;;) {
+			result = realloc(p, n);
+			if(result) return result;
+			handler = malloc_alloc_oom_handler;
+			if(!handler) {
+				std::cerr<<"out of memory!"<<std::endl;
+				exit(1);
+			}
+			(*handler)();
+		}
+	}
+}
+#endif
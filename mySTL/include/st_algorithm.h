@@ -2,9 +2,77 @@
 #define ST_ALGORITHM_H
 
 #include "st_iterator.h"
+#include "st_typetrait.h"
+#include "st_bulk_ops.h"
+#include <utility>
 
 namespace tinySTL {
 
+    //*******************bulk dispatch**************************************
+    template <class Iterator>
+    struct _is_contiguous {
+        enum {value = std::is_same<typename iterator_traits<Iterator>::iterator_category,
+                                   contiguous_iterator_tag>::value};
+    };
+
+    template <class T>
+    struct _trivially_assignable {
+        enum {value = std::is_same<typename _type_traits<T>::has_trivial_assignment_operator, _true_type>::value};
+    };
+
+    //element type of a contiguous range, const stripped
+    template <class Iterator>
+    struct _contiguous_value {
+        typedef typename std::remove_cv<typename iterator_traits<Iterator>::value_type>::type type;
+    };
+
+    //contiguous ranges of trivially assignable elements are copied as bytes
+    template <class InputIterator, class OutputIterator>
+    struct _bulk_assignable {
+        typedef typename _contiguous_value<InputIterator>::type     _in;
+        typedef typename _contiguous_value<OutputIterator>::type    _out;
+        typedef typename _bool_type<_is_contiguous<InputIterator>::value && _is_contiguous<OutputIterator>::value
+                                    && std::is_same<_in, _out>::value
+                                    && _trivially_assignable<_out>::value>::type type;
+    };
+
+    //and filled through memset or the pattern kernel
+    template <class ForwardIterator, class T>
+    struct _bulk_fillable {
+        typedef typename _contiguous_value<ForwardIterator>::type   _value;
+        typedef typename _bool_type<_is_contiguous<ForwardIterator>::value
+                                    && std::is_same<_value, T>::value
+                                    && _trivially_assignable<_value>::value>::type type;
+    };
+
+    //and compared for equality with memcmp when equal values have equal
+    //bytes, which holds for integers and pointers but not for floats
+    template <class InputIterator1, class InputIterator2>
+    struct _bulk_comparable {
+        typedef typename _contiguous_value<InputIterator1>::type    _value;
+        typedef typename _bool_type<_is_contiguous<InputIterator1>::value && _is_contiguous<InputIterator2>::value
+                                    && std::is_same<_value, typename _contiguous_value<InputIterator2>::type>::value
+                                    && (std::is_integral<_value>::value || std::is_pointer<_value>::value)
+                                    && !std::is_same<_value, bool>::value>::type type;
+    };
+
+    //and ordered with memcmp when the elements are unsigned bytes
+    template <class InputIterator1, class InputIterator2>
+    struct _bulk_orderable {
+        typedef typename _contiguous_value<InputIterator1>::type    _value;
+        typedef typename _bool_type<_is_contiguous<InputIterator1>::value && _is_contiguous<InputIterator2>::value
+                                    && std::is_same<_value, typename _contiguous_value<InputIterator2>::type>::value
+                                    && sizeof(_value) == 1 && std::is_integral<_value>::value
+                                    && std::is_unsigned<_value>::value && !std::is_same<_value, bool>::value>::type type;
+    };
+
+    //segmented iterators are walked one segment at a time, each segment
+    //is a local pointer range handed to the kernels for contiguous ranges
+    template <class Iterator>
+    struct _is_segmented {
+        typedef typename segmented_iterator_traits<Iterator>::is_segmented_iterator type;
+    };
+
     //*******************less**************************************
     template <class T>
     struct less {
@@ -12,6 +80,13 @@ namespace tinySTL {
             return x<y;
         }
     };
+    //*******************identity**************************************
+    template <class T>
+    struct identity {
+        const T& operator()(const T& x) const {
+            return x;
+        }
+    };
     template <class T>
     const T max(const T& a, const T& b) {
         return (a > b ? a : b );
@@ -23,14 +98,19 @@ namespace tinySTL {
 
     template <class T>
     void swap(T& a, T& b) {
-        T tmp;
-        tmp = a;
-        a = b;
-        b = tmp;
+        T tmp(std::move(a));
+        a = std::move(b);
+        b = std::move(tmp);
     }
 
     template <class InputIterator1, class InputIterator2>
-        bool equal (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+        bool _equal_aux (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _true_type) {
+            size_t n = last1 - first1;
+            return n == 0 || memcmp (&*first1, &*first2, n * sizeof(*first1)) == 0;
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _equal_aux (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _false_type) {
             while (first1 != last1) {
                 if( *first1 != *first2) return false;
                 ++first1; ++first2;
@@ -38,6 +118,80 @@ namespace tinySTL {
             return true;
         }
 
+    //the first range is cut where the segments of the second one end
+    template <class InputIterator1, class SegmentedIterator>
+        bool _equal_to_segments (InputIterator1 first1, InputIterator1 last1, SegmentedIterator first2,
+                                 random_access_iterator_tag) {
+            typedef segmented_iterator_traits<SegmentedIterator>   _traits;
+            typedef typename _traits::local_iterator                _local;
+            typedef typename _bulk_comparable<InputIterator1, _local>::type _bulk;
+            while (first1 != last1) {
+                _local cur = _traits::local (first2);
+                ptrdiff_t n = min<ptrdiff_t> (_traits::end (_traits::segment (first2)) - cur, last1 - first1);
+                if (!_equal_aux (first1, first1 + n, cur, _bulk())) return false;
+                first1 += n;
+                first2 += n;
+            }
+            return true;
+        }
+
+    template <class InputIterator1, class SegmentedIterator>
+        bool _equal_to_segments (InputIterator1 first1, InputIterator1 last1, SegmentedIterator first2,
+                                 input_iterator_tag) {
+            return _equal_aux (first1, last1, first2, _false_type());
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _equal_out (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _true_type) {
+            return _equal_to_segments (first1, last1, first2, iterator_category (first1));
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _equal_out (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _false_type) {
+            typedef typename _bulk_comparable<InputIterator1, InputIterator2>::type _bulk;
+            return _equal_aux (first1, last1, first2, _bulk());
+        }
+
+    //each segment of the first range is compared in one piece
+    template <class SegmentedIterator, class InputIterator2>
+        bool _equal_segments (SegmentedIterator first1, SegmentedIterator last1, InputIterator2 first2,
+                              random_access_iterator_tag) {
+            typedef segmented_iterator_traits<SegmentedIterator>   _traits;
+            typedef typename _traits::local_iterator                _local;
+            typedef typename _is_segmented<InputIterator2>::type    _seg;
+            typename _traits::segment_iterator seg = _traits::segment (first1), last = _traits::segment (last1);
+            _local begin = _traits::local (first1);
+            for (; seg != last; ++seg, begin = _traits::begin (seg)) {
+                _local end = _traits::end (seg);
+                if (!_equal_out (begin, end, first2, _seg())) return false;
+                first2 += end - begin;
+            }
+            return _equal_out (begin, _traits::local (last1), first2, _seg());
+        }
+
+    template <class SegmentedIterator, class InputIterator2>
+        bool _equal_segments (SegmentedIterator first1, SegmentedIterator last1, InputIterator2 first2,
+                              input_iterator_tag) {
+            return _equal_aux (first1, last1, first2, _false_type());
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _equal_in (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _true_type) {
+            return _equal_segments (first1, last1, first2, iterator_category (first2));
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _equal_in (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, _false_type) {
+            typedef typename _is_segmented<InputIterator2>::type _seg;
+            return _equal_out (first1, last1, first2, _seg());
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool equal (InputIterator1 first1, InputIterator1 last1, InputIterator2 first2) {
+            typedef typename _is_segmented<InputIterator1>::type _seg;
+            return _equal_in (first1, last1, first2, _seg());
+        }
+
     template <class InputIterator1, class InputIterator2, class BinaryPredicate>
         bool equal (InputIterator1 first1, InputIterator1 last1,
                     InputIterator2 first2, BinaryPredicate pred) {
@@ -72,10 +226,41 @@ namespace tinySTL {
             return _distance(first, last, category());
         }
 
+    //*******************iterartor advance**************************************
+    template <class InputIterator, class Distance>
+        inline void _advance (InputIterator& it, Distance n, input_iterator_tag) {
+            for (; n > 0; --n) ++it;
+        }
+    template <class BiDirectionIterator, class Distance>
+        inline void _advance (BiDirectionIterator& it, Distance n, bidirectional_iterator_tag) {
+            for (; n > 0; --n) ++it;
+            for (; n < 0; ++n) --it;
+        }
+    template <class RandomAccessIterator, class Distance>
+        inline void _advance (RandomAccessIterator& it, Distance n, random_access_iterator_tag) {
+            it += n;
+        }
+
+    template <class InputIterator, class Distance>
+        inline void advance (InputIterator& it, Distance n) {
+            typedef typename iterator_traits<InputIterator>::iterator_category   category;
+            _advance(it, n, category());
+        }
+
     // ************* lexicographical compare***************************************
     template <class InputIterator1, class InputIterator2>
-        bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
-                                     InputIterator2 first2, InputIterator2 last2) {
+        bool _lexicographical_compare_aux(InputIterator1 first1, InputIterator1 last1,
+                                          InputIterator2 first2, InputIterator2 last2, _true_type) {
+            size_t n1 = last1 - first1;
+            size_t n2 = last2 - first2;
+            size_t n = n1 < n2 ? n1 : n2;
+            int result = n == 0 ? 0 : memcmp (&*first1, &*first2, n);
+            return result != 0 ? result < 0 : n1 < n2;
+        }
+
+    template <class InputIterator1, class InputIterator2>
+        bool _lexicographical_compare_aux(InputIterator1 first1, InputIterator1 last1,
+                                          InputIterator2 first2, InputIterator2 last2, _false_type) {
             while (first1 != last1) {
                 if( first2 == last2 || *first1 > *first2) return false;
                 else if(*first1 < *first2) return true;
@@ -84,41 +269,351 @@ namespace tinySTL {
             return (first2 != last2);
         }
 
+    template <class InputIterator1, class InputIterator2>
+        bool lexicographical_compare(InputIterator1 first1, InputIterator1 last1,
+                                     InputIterator2 first2, InputIterator2 last2) {
+            typedef typename _bulk_orderable<InputIterator1, InputIterator2>::type _bulk;
+            return _lexicographical_compare_aux(first1, last1, first2, last2, _bulk());
+        }
+
+
+
+
+    template <class ForwardIterator, class Size, class T>
+    ForwardIterator _fill_n_aux(ForwardIterator start, Size size, const T& x, _true_type) {
+        if(size <= 0) return start;
+        _bulk_fill(&*start, (size_t)size, x);
+        return start + size;
+    }
 
+    template <class ForwardIterator, class Size, class T>
+    ForwardIterator _fill_n_aux(ForwardIterator start, Size size, const T& x, _false_type) {
+        for(; size > 0; --size, ++start)
+            *start = x;
+        return start;
+    }
+
+    //a segmented range is filled up to the end of each segment in turn
+    template <class ForwardIterator, class Size, class T>
+    ForwardIterator _fill_n_segmented(ForwardIterator start, Size size, const T& x, _true_type) {
+        typedef segmented_iterator_traits<ForwardIterator>      _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_fillable<_local, T>::type        _bulk;
+        while(size > 0) {
+            _local cur = _traits::local(start);
+            ptrdiff_t n = min<ptrdiff_t>(_traits::end(_traits::segment(start)) - cur, size);
+            _fill_n_aux(cur, n, x, _bulk());
+            start += n;
+            size -= n;
+        }
+        return start;
+    }
+
+    template <class ForwardIterator, class Size, class T>
+    ForwardIterator _fill_n_segmented(ForwardIterator start, Size size, const T& x, _false_type) {
+        typedef typename _bulk_fillable<ForwardIterator, T>::type _bulk;
+        return _fill_n_aux(start, size, x, _bulk());
+    }
 
     template <class ForwardIterator, class Size, class T>
     ForwardIterator fill_n(ForwardIterator start, Size size, const T& x) {
-        for(Size i=0; i<size; ++i)
-            *(start+i) = x;
-        return (start+size);
+        typedef typename _is_segmented<ForwardIterator>::type _seg;
+        return _fill_n_segmented(start, size, x, _seg());
     }
 
     template <class ForwardIterator, class InputIterator>
-    ForwardIterator copy(InputIterator start, InputIterator end, ForwardIterator result){
-        for(int i=0;start + i != end; ++i, ++result) {
-            *result = *(start+i);
+    ForwardIterator _copy_aux(InputIterator start, InputIterator end, ForwardIterator result, _true_type) {
+        size_t n = end - start;
+        if(n) _bulk_copy(&*start, n, &*result);
+        return result + n;
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _copy_aux(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        for(; start != end; ++start, ++result)
+            *result = *start;
+        return result;
+    }
+
+    //the input is cut where the segments of result end
+    template <class SegmentedIterator, class InputIterator>
+    SegmentedIterator _copy_to_segments(InputIterator start, InputIterator end, SegmentedIterator result,
+                                        random_access_iterator_tag) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_assignable<InputIterator, _local>::type _bulk;
+        while(start != end) {
+            _local cur = _traits::local(result);
+            ptrdiff_t n = min<ptrdiff_t>(_traits::end(_traits::segment(result)) - cur, end - start);
+            _copy_aux(start, start + n, cur, _bulk());
+            start += n;
+            result += n;
         }
         return result;
     }
 
+    template <class SegmentedIterator, class InputIterator>
+    SegmentedIterator _copy_to_segments(InputIterator start, InputIterator end, SegmentedIterator result,
+                                        input_iterator_tag) {
+        return _copy_aux(start, end, result, _false_type());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _copy_out(InputIterator start, InputIterator end, ForwardIterator result, _true_type) {
+        return _copy_to_segments(start, end, result, iterator_category(start));
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _copy_out(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        typedef typename _bulk_assignable<InputIterator, ForwardIterator>::type _bulk;
+        return _copy_aux(start, end, result, _bulk());
+    }
+
+    //each segment of the input is copied in one piece
+    template <class ForwardIterator, class SegmentedIterator>
+    ForwardIterator _copy_in(SegmentedIterator start, SegmentedIterator end, ForwardIterator result, _true_type) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _is_segmented<ForwardIterator>::type   _seg;
+        typename _traits::segment_iterator seg = _traits::segment(start), last = _traits::segment(end);
+        _local begin = _traits::local(start);
+        for(; seg != last; ++seg, begin = _traits::begin(seg))
+            result = _copy_out(begin, _traits::end(seg), result, _seg());
+        return _copy_out(begin, _traits::local(end), result, _seg());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _copy_in(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        typedef typename _is_segmented<ForwardIterator>::type _seg;
+        return _copy_out(start, end, result, _seg());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator copy(InputIterator start, InputIterator end, ForwardIterator result){
+        typedef typename _is_segmented<InputIterator>::type _seg;
+        return _copy_in(start, end, result, _seg());
+    }
+
     template <class ForwardIterator, class T>
-    ForwardIterator fill(ForwardIterator start, ForwardIterator end, const T& x) {
+    ForwardIterator _fill_aux(ForwardIterator start, ForwardIterator end, const T& x, _true_type) {
+        if(start != end) _bulk_fill(&*start, end - start, x);
+        return end;
+    }
+
+    template <class ForwardIterator, class T>
+    ForwardIterator _fill_aux(ForwardIterator start, ForwardIterator end, const T& x, _false_type) {
         for(;start != end; ++start)
             *start = x;
         return start;
     }
 
+    template <class ForwardIterator, class T>
+    ForwardIterator _fill_segmented(ForwardIterator start, ForwardIterator end, const T& x, _true_type) {
+        typedef segmented_iterator_traits<ForwardIterator>      _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_fillable<_local, T>::type        _bulk;
+        typename _traits::segment_iterator seg = _traits::segment(start), last = _traits::segment(end);
+        _local begin = _traits::local(start);
+        for(; seg != last; ++seg, begin = _traits::begin(seg))
+            _fill_aux(begin, _traits::end(seg), x, _bulk());
+        _fill_aux(begin, _traits::local(end), x, _bulk());
+        return end;
+    }
+
+    template <class ForwardIterator, class T>
+    ForwardIterator _fill_segmented(ForwardIterator start, ForwardIterator end, const T& x, _false_type) {
+        typedef typename _bulk_fillable<ForwardIterator, T>::type _bulk;
+        return _fill_aux(start, end, x, _bulk());
+    }
+
+    template <class ForwardIterator, class T>
+    ForwardIterator fill(ForwardIterator start, ForwardIterator end, const T& x) {
+        typedef typename _is_segmented<ForwardIterator>::type _seg;
+        return _fill_segmented(start, end, x, _seg());
+    }
+
+    //the n elements end at result, so they start n - 1 before it
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_copy_aux(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _true_type) {
+        size_t n = last - first;
+        if(n) _bulk_copy(&*first, n, &*result - (n - 1));
+        return result - n;
+    }
+
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_copy_aux(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _false_type) {
+        while(last != first) {
+            --last;
+            *result = *last;
+            --result;
+        }
+        return result;
+    }
+
+    //the piece copied at a time ends at last and fits in the segments of
+    //both last and result
+    template <class SegmentedIterator>
+    SegmentedIterator
+    _backward_copy_segmented(SegmentedIterator first, SegmentedIterator last, SegmentedIterator result, _true_type) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_assignable<_local, _local>::type _bulk;
+        while(last != first) {
+            typename _traits::segment_iterator seg = _traits::segment(last);
+            _local end = _traits::local(last);
+            if(end == _traits::begin(seg))
+                end = _traits::end(--seg);
+            _local cur = _traits::local(result);
+            ptrdiff_t n = min<ptrdiff_t>(end - _traits::begin(seg), cur - _traits::begin(_traits::segment(result)) + 1);
+            n = min<ptrdiff_t>(n, last - first);
+            _backward_copy_aux(end - n, end, cur, _bulk());
+            last -= n;
+            result -= n;
+        }
+        return result;
+    }
+
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_copy_segmented(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _false_type) {
+        typedef typename _bulk_assignable<BiDirectionIterator, BiDirectionIterator>::type _bulk;
+        return _backward_copy_aux(first, last, result, _bulk());
+    }
+
+    //copy [first, last) backwards, result is the position of the last element
     template <class BiDirectionIterator>
     BiDirectionIterator 
     backward_copy(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result) {
-        --last;
-        for(;last != first - 1; --last, --result)
-            *result = *last;
+        typedef typename _is_segmented<BiDirectionIterator>::type _seg;
+        return _backward_copy_segmented(first, last, result, _seg());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _move_aux(InputIterator start, InputIterator end, ForwardIterator result, _true_type) {
+        size_t n = end - start;
+        if(n) _bulk_copy(&*start, n, &*result);
+        return result + n;
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _move_aux(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        for(; start != end; ++start, ++result)
+            *result = std::move(*start);
+        return result;
+    }
+
+    template <class SegmentedIterator, class InputIterator>
+    SegmentedIterator _move_to_segments(InputIterator start, InputIterator end, SegmentedIterator result,
+                                        random_access_iterator_tag) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_assignable<InputIterator, _local>::type _bulk;
+        while(start != end) {
+            _local cur = _traits::local(result);
+            ptrdiff_t n = min<ptrdiff_t>(_traits::end(_traits::segment(result)) - cur, end - start);
+            _move_aux(start, start + n, cur, _bulk());
+            start += n;
+            result += n;
+        }
+        return result;
+    }
+
+    template <class SegmentedIterator, class InputIterator>
+    SegmentedIterator _move_to_segments(InputIterator start, InputIterator end, SegmentedIterator result,
+                                        input_iterator_tag) {
+        return _move_aux(start, end, result, _false_type());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _move_out(InputIterator start, InputIterator end, ForwardIterator result, _true_type) {
+        return _move_to_segments(start, end, result, iterator_category(start));
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _move_out(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        typedef typename _bulk_assignable<InputIterator, ForwardIterator>::type _bulk;
+        return _move_aux(start, end, result, _bulk());
+    }
+
+    template <class ForwardIterator, class SegmentedIterator>
+    ForwardIterator _move_in(SegmentedIterator start, SegmentedIterator end, ForwardIterator result, _true_type) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _is_segmented<ForwardIterator>::type   _seg;
+        typename _traits::segment_iterator seg = _traits::segment(start), last = _traits::segment(end);
+        _local begin = _traits::local(start);
+        for(; seg != last; ++seg, begin = _traits::begin(seg))
+            result = _move_out(begin, _traits::end(seg), result, _seg());
+        return _move_out(begin, _traits::local(end), result, _seg());
+    }
+
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator _move_in(InputIterator start, InputIterator end, ForwardIterator result, _false_type) {
+        typedef typename _is_segmented<ForwardIterator>::type _seg;
+        return _move_out(start, end, result, _seg());
+    }
+
+    //copy that moves each element out of [start, end)
+    template <class ForwardIterator, class InputIterator>
+    ForwardIterator move(InputIterator start, InputIterator end, ForwardIterator result) {
+        typedef typename _is_segmented<InputIterator>::type _seg;
+        return _move_in(start, end, result, _seg());
+    }
+
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_move_aux(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _true_type) {
+        return _backward_copy_aux(first, last, result, _true_type());
+    }
+
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_move_aux(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _false_type) {
+        while(last != first) {
+            --last;
+            *result = std::move(*last);
+            --result;
+        }
         return result;
     }
 
+    template <class SegmentedIterator>
+    SegmentedIterator
+    _backward_move_segmented(SegmentedIterator first, SegmentedIterator last, SegmentedIterator result, _true_type) {
+        typedef segmented_iterator_traits<SegmentedIterator>    _traits;
+        typedef typename _traits::local_iterator                _local;
+        typedef typename _bulk_assignable<_local, _local>::type _bulk;
+        while(last != first) {
+            typename _traits::segment_iterator seg = _traits::segment(last);
+            _local end = _traits::local(last);
+            if(end == _traits::begin(seg))
+                end = _traits::end(--seg);
+            _local cur = _traits::local(result);
+            ptrdiff_t n = min<ptrdiff_t>(end - _traits::begin(seg), cur - _traits::begin(_traits::segment(result)) + 1);
+            n = min<ptrdiff_t>(n, last - first);
+            _backward_move_aux(end - n, end, cur, _bulk());
+            last -= n;
+            result -= n;
+        }
+        return result;
+    }
 
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    _backward_move_segmented(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result, _false_type) {
+        typedef typename _bulk_assignable<BiDirectionIterator, BiDirectionIterator>::type _bulk;
+        return _backward_move_aux(first, last, result, _bulk());
+    }
 
+    //backward_copy that moves, result is the position of the last element
+    template <class BiDirectionIterator>
+    BiDirectionIterator
+    backward_move(BiDirectionIterator first, BiDirectionIterator last, BiDirectionIterator result) {
+        typedef typename _is_segmented<BiDirectionIterator>::type _seg;
+        return _backward_move_segmented(first, last, result, _seg());
+    }
 
 }
 
@@ -0,0 +1,204 @@
+#ifndef ST_ALLOC_STATS_H
+#define ST_ALLOC_STATS_H
+#include <stddef.h>
+#include <atomic>
+#include <mutex>
+#include <ostream>
+
+//Allocator counters are only updated when ST_ALLOC_STATS is defined; the
+//interface is always there and reads as zero otherwise.
+
+namespace tinySTL {
+    //copy of the counters of one allocator, taken counter by counter
+    struct alloc_stats_snapshot {
+        enum {MAX_CLASSES = 64};
+
+        const char* name;
+        bool        enabled;
+        size_t      nclasses;
+        size_t      class_limit[MAX_CLASSES];   //largest request of the class, 0 for no bound
+        size_t      allocs[MAX_CLASSES];
+        size_t      deallocs[MAX_CLASSES];
+        size_t      bytes_in_use;               //bytes handed out to live blocks
+        size_t      requested_in_use;           //bytes asked for by live blocks
+        size_t      high_water;                 //peak of bytes_in_use
+        size_t      reserved_bytes;             //held from the system, 0 if not tracked
+        size_t      refills;
+        size_t      chunk_allocs;
+
+        //bytes lost to size class rounding
+        size_t internal_fragmentation () const { return bytes_in_use - requested_in_use; }
+    };
+
+    //Counters of one allocator. Every instance registers itself so that
+    //dump_all can report all allocators of the process.
+    class alloc_stats {
+    public:
+        typedef size_t (*limit_fn)(size_t);
+        enum {MAX_CLASSES = alloc_stats_snapshot::MAX_CLASSES};
+        //classes of power of two sizes from 8 bytes, the last one is open
+        enum {POW2_CLASSES = 32};
+
+    private:
+        const char*             name;
+        size_t                  nclasses;
+        limit_fn                limit;
+        std::atomic<size_t>     allocs[MAX_CLASSES];
+        std::atomic<size_t>     deallocs[MAX_CLASSES];
+        std::atomic<size_t>     bytes_in_use;
+        std::atomic<size_t>     requested_in_use;
+        std::atomic<size_t>     high_water;
+        std::atomic<size_t>     reserved;
+        std::atomic<size_t>     refills;
+        std::atomic<size_t>     chunk_allocs;
+        alloc_stats*            next;
+
+        alloc_stats(const alloc_stats&);
+        alloc_stats& operator=(const alloc_stats&);
+
+        static std::mutex& registry_lock() {
+            static std::mutex lock;
+            return lock;
+        }
+        static alloc_stats*& registry() {
+            static alloc_stats* head = 0;
+            return head;
+        }
+
+    public:
+        alloc_stats(const char* n, size_t classes, limit_fn fn)
+            : name(n), nclasses(classes < MAX_CLASSES ? classes : (size_t)MAX_CLASSES), limit(fn) {
+            for(size_t i = 0; i < MAX_CLASSES; ++i) {
+                allocs[i].store(0, std::memory_order_relaxed);
+                deallocs[i].store(0, std::memory_order_relaxed);
+            }
+            bytes_in_use.store(0, std::memory_order_relaxed);
+            requested_in_use.store(0, std::memory_order_relaxed);
+            high_water.store(0, std::memory_order_relaxed);
+            reserved.store(0, std::memory_order_relaxed);
+            refills.store(0, std::memory_order_relaxed);
+            chunk_allocs.store(0, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> guard(registry_lock());
+            next = registry();
+            registry() = this;
+        }
+
+        ~alloc_stats() {
+            std::lock_guard<std::mutex> guard(registry_lock());
+            alloc_stats** link = &registry();
+            while(*link != this)
+                link = &(*link)->next;
+            *link = next;
+        }
+
+        static size_t pow2_class(size_t bytes) {
+            size_t cls = 0;
+            while(cls < POW2_CLASSES - 1 && ((size_t)8 << cls) < bytes)
+                ++cls;
+            return cls;
+        }
+        static size_t pow2_limit(size_t cls) {
+            return cls < POW2_CLASSES - 1 ? (size_t)8 << cls : 0;
+        }
+
+        //a block of class cls was asked for requested bytes and got granted
+        void record_alloc(size_t cls, size_t requested, size_t granted) {
+            if(cls >= nclasses) cls = nclasses - 1;
+            allocs[cls].fetch_add(1, std::memory_order_relaxed);
+            requested_in_use.fetch_add(requested, std::memory_order_relaxed);
+            size_t now = bytes_in_use.fetch_add(granted, std::memory_order_relaxed) + granted;
+            size_t peak = high_water.load(std::memory_order_relaxed);
+            while(now > peak && !high_water.compare_exchange_weak(peak, now, std::memory_order_relaxed))
+                ;
+        }
+        void record_dealloc(size_t cls, size_t requested, size_t granted) {
+            if(cls >= nclasses) cls = nclasses - 1;
+            deallocs[cls].fetch_add(1, std::memory_order_relaxed);
+            requested_in_use.fetch_sub(requested, std::memory_order_relaxed);
+            bytes_in_use.fetch_sub(granted, std::memory_order_relaxed);
+        }
+        void record_refill() { refills.fetch_add(1, std::memory_order_relaxed); }
+        void record_chunk_alloc() { chunk_allocs.fetch_add(1, std::memory_order_relaxed); }
+        //bytes taken from or given back to the system
+        void record_reserve(size_t bytes) { reserved.fetch_add(bytes, std::memory_order_relaxed); }
+        void record_release(size_t bytes) { reserved.fetch_sub(bytes, std::memory_order_relaxed); }
+
+        void snapshot(alloc_stats_snapshot& out) const {
+            out.name = name;
+#ifdef ST_ALLOC_STATS
+            out.enabled = true;
+#else
+            out.enabled = false;
+#endif
+            out.nclasses = nclasses;
+            for(size_t i = 0; i < nclasses; ++i) {
+                out.class_limit[i] = limit(i);
+                out.allocs[i] = allocs[i].load(std::memory_order_relaxed);
+                out.deallocs[i] = deallocs[i].load(std::memory_order_relaxed);
+            }
+            out.bytes_in_use = bytes_in_use.load(std::memory_order_relaxed);
+            out.requested_in_use = requested_in_use.load(std::memory_order_relaxed);
+            out.high_water = high_water.load(std::memory_order_relaxed);
+            out.reserved_bytes = reserved.load(std::memory_order_relaxed);
+            out.refills = refills.load(std::memory_order_relaxed);
+            out.chunk_allocs = chunk_allocs.load(std::memory_order_relaxed);
+        }
+
+        //write every registered allocator, as text or as a JSON array
+        static void dump_all(std::ostream& os, bool json);
+    };
+
+    inline void dump_text(std::ostream& os, const alloc_stats_snapshot& s) {
+        os << s.name << (s.enabled ? "" : " (stats disabled)") << ":\n"
+           << "  in use " << s.bytes_in_use << " B, requested " << s.requested_in_use
+           << " B, internal fragmentation " << s.internal_fragmentation() << " B\n"
+           << "  high water " << s.high_water << " B, reserved " << s.reserved_bytes
+           << " B, refills " << s.refills << ", chunk_allocs " << s.chunk_allocs << "\n";
+        for(size_t i = 0; i < s.nclasses; ++i) {
+            if(s.allocs[i] == 0) continue;
+            os << "  class ";
+            if(s.class_limit[i]) os << "<= " << s.class_limit[i];
+            else os << "larger";
+            os << ": " << s.allocs[i] << " allocs, " << s.deallocs[i] << " deallocs, "
+               << s.allocs[i] - s.deallocs[i] << " live\n";
+        }
+    }
+
+    inline void dump_json(std::ostream& os, const alloc_stats_snapshot& s) {
+        os << "{\"name\":\"" << s.name << "\",\"enabled\":" << (s.enabled ? "true" : "false")
+           << ",\"bytes_in_use\":" << s.bytes_in_use
+           << ",\"requested_in_use\":" << s.requested_in_use
+           << ",\"internal_fragmentation\":" << s.internal_fragmentation()
+           << ",\"high_water\":" << s.high_water
+           << ",\"reserved_bytes\":" << s.reserved_bytes
+           << ",\"refills\":" << s.refills
+           << ",\"chunk_allocs\":" << s.chunk_allocs
+           << ",\"classes\":[";
+        bool first = true;
+        for(size_t i = 0; i < s.nclasses; ++i) {
+            if(s.allocs[i] == 0) continue;
+            os << (first ? "" : ",") << "{\"limit\":" << s.class_limit[i]
+               << ",\"allocs\":" << s.allocs[i] << ",\"deallocs\":" << s.deallocs[i] << "}";
+            first = false;
+        }
+        os << "]}";
+    }
+
+    inline void alloc_stats::dump_all(std::ostream& os, bool json) {
+        std::lock_guard<std::mutex> guard(registry_lock());
+        alloc_stats_snapshot s;
+        if(json) os << "[";
+        for(alloc_stats* p = registry(); p; p = p->next) {
+            p->snapshot(s);
+            if(json) {
+                dump_json(os, s);
+                if(p->next) os << ",";
+            } else {
+                dump_text(os, s);
+            }
+        }
+        if(json) os << "]\n";
+    }
+}
+#endif // ST_ALLOC_STATS_H
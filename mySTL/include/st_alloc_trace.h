@@ -0,0 +1,138 @@
+#ifndef ST_ALLOC_TRACE_H
+#define ST_ALLOC_TRACE_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <unordered_map>
+
+//Recording is compiled into simple_alloc when ST_ALLOC_TRACE is defined.
+//Events go to the file named by ST_ALLOC_TRACE_FILE, alloc.trace if unset.
+//The file is the 8 byte trace_magic followed by trace_records.
+
+namespace tinySTL {
+    enum trace_op {TRACE_ALLOC = 0, TRACE_FREE = 1, TRACE_REALLOC = 2};
+
+    //one event; id names a block from its allocation to its free, keeps
+    //across a reallocate and is handed out again after the free
+    struct trace_record {
+        uint64_t    time_ns;    //since the recorder started
+        uint64_t    size;       //bytes asked for, 0 for a free
+        uint32_t    id;
+        uint32_t    op;
+    };
+
+    inline const char* trace_magic() { return "STTRACE1"; }
+
+    //false unless f starts with the trace magic
+    inline bool read_trace_header(FILE* f) {
+        char magic[8];
+        return fread(magic, 1, 8, f) == 8 && memcmp(magic, trace_magic(), 8) == 0;
+    }
+
+    class alloc_trace_recorder {
+    private:
+        enum {_BUFFER = 4096};
+
+        std::mutex                          lock;
+        FILE*                               out;
+        std::unordered_map<void*, uint32_t> ids;
+        std::vector<uint32_t>               free_ids;
+        uint32_t                            next_id;
+        trace_record                        buf[_BUFFER];
+        size_t                              nbuf;
+        std::chrono::steady_clock::time_point start;
+
+        alloc_trace_recorder() : out(0), next_id(0), nbuf(0), start(std::chrono::steady_clock::now()) {
+            const char* path = getenv("ST_ALLOC_TRACE_FILE");
+            out = fopen(path ? path : "alloc.trace", "wb");
+            if(out) fwrite(trace_magic(), 1, 8, out);
+        }
+        alloc_trace_recorder(const alloc_trace_recorder&);
+        alloc_trace_recorder& operator=(const alloc_trace_recorder&);
+
+        static void flush_at_exit() { instance().flush(); }
+        static alloc_trace_recorder* create() {
+            alloc_trace_recorder* recorder = new alloc_trace_recorder;
+            atexit(flush_at_exit);
+            return recorder;
+        }
+
+        //called with lock held
+        void push(uint32_t op, uint32_t id, size_t size) {
+            trace_record& r = buf[nbuf++];
+            r.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+            r.size = size;
+            r.id = id;
+            r.op = op;
+            if(nbuf == _BUFFER) write_buffer();
+        }
+        void write_buffer() {
+            if(out && nbuf) fwrite(buf, sizeof(trace_record), nbuf, out);
+            nbuf = 0;
+        }
+        uint32_t new_id() {
+            if(free_ids.empty()) return next_id++;
+            uint32_t id = free_ids.back();
+            free_ids.pop_back();
+            return id;
+        }
+
+    public:
+        //never destroyed, so blocks freed by static destructors can still
+        //be looked up; events after the exit flush are dropped
+        static alloc_trace_recorder& instance() {
+            static alloc_trace_recorder* recorder = create();
+            return *recorder;
+        }
+
+        void record_alloc(void* p, size_t size) {
+            if(!p) return;
+            std::lock_guard<std::mutex> guard(lock);
+            uint32_t id = new_id();
+            ids[p] = id;
+            push(TRACE_ALLOC, id, size);
+        }
+
+        //must come before the block is given back, so that the address
+        //cannot be handed out and recorded again in between
+        void record_free(void* p) {
+            if(!p) return;
+            std::lock_guard<std::mutex> guard(lock);
+            std::unordered_map<void*, uint32_t>::iterator it = ids.find(p);
+            if(it == ids.end()) return;
+            push(TRACE_FREE, it->second, 0);
+            free_ids.push_back(it->second);
+            ids.erase(it);
+        }
+
+        //a reallocate is recorded in two steps: the id is taken from the
+        //old address before the block is given back, then moves to the new one
+        uint32_t detach(void* old) {
+            std::lock_guard<std::mutex> guard(lock);
+            std::unordered_map<void*, uint32_t>::iterator it = old ? ids.find(old) : ids.end();
+            if(it == ids.end()) return new_id();
+            uint32_t id = it->second;
+            ids.erase(it);
+            return id;
+        }
+
+        void record_realloc(uint32_t id, void* p, size_t size) {
+            std::lock_guard<std::mutex> guard(lock);
+            ids[p] = id;
+            push(TRACE_REALLOC, id, size);
+        }
+
+        void flush() {
+            std::lock_guard<std::mutex> guard(lock);
+            write_buffer();
+            if(out) fflush(out);
+        }
+    };
+}
+#endif // ST_ALLOC_TRACE_H
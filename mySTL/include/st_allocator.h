@@ -2,7 +2,12 @@
 #define ST_ALLOCATOR_H
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
 #include <iostream>
+#include "st_alloc_stats.h"
+#ifdef ST_ALLOC_TRACE
+#include "st_alloc_trace.h"
+#endif
 
 namespace tinySTL {
     class SimpleAlloc {
@@ -21,10 +26,18 @@ namespace tinySTL {
         static pointer  oom_realloc(pointer begin, size_type nbytes);
         static void (*my_oom_malloc_handler)();
         static void set_my_malloc_handler(void (*f)());
+#ifdef ST_ALLOC_STATS
+        //with stats on every block carries its size in front
+        enum {_STATS_HEADER = 16};
+#endif
     public:
         static pointer allocate(size_type nbytes);
         static pointer reallocate(pointer begin, size_type nbytes);
         static void deallocate(pointer begin);
+        static alloc_stats& stats() {
+            static alloc_stats instance("SimpleAlloc", alloc_stats::POW2_CLASSES, alloc_stats::pow2_limit);
+            return instance;
+        }
     };
 
     void (*SimpleAlloc::my_oom_malloc_handler)() = 0; //set by user
@@ -74,43 +87,207 @@ namespace tinySTL {
     }
 
     typename SimpleAlloc::pointer SimpleAlloc::allocate(size_type nbytes) {
-        pointer result = static_cast<pointer>(malloc(nbytes));
+#ifdef ST_ALLOC_STATS
+        size_type real = nbytes + _STATS_HEADER;
+#else
+        size_type real = nbytes;
+#endif
+        pointer result = static_cast<pointer>(malloc(real));
         if(!result)
-            oom_alloc(nbytes);
+            result = oom_alloc(real);
+#ifdef ST_ALLOC_STATS
+        *(size_type*)result = nbytes;
+        result = (char*)result + _STATS_HEADER;
+        stats().record_alloc(alloc_stats::pow2_class(nbytes), nbytes, nbytes);
+#endif
 
         return result;
     }
 
     typename SimpleAlloc::pointer SimpleAlloc::reallocate(pointer begin, size_type nbytes) {
-        pointer result = static_cast<pointer>(realloc(begin, nbytes));
+#ifdef ST_ALLOC_STATS
+        if(!begin)
+            return allocate(nbytes);
+        begin = (char*)begin - _STATS_HEADER;
+        size_type old_size = *(size_type*)begin;
+        size_type real = nbytes + _STATS_HEADER;
+#else
+        size_type real = nbytes;
+#endif
+        pointer result = static_cast<pointer>(realloc(begin, real));
 
         if(!result)
-            oom_realloc(begin, nbytes);
+            result = oom_realloc(begin, real);
+#ifdef ST_ALLOC_STATS
+        *(size_type*)result = nbytes;
+        result = (char*)result + _STATS_HEADER;
+        stats().record_dealloc(alloc_stats::pow2_class(old_size), old_size, old_size);
+        stats().record_alloc(alloc_stats::pow2_class(nbytes), nbytes, nbytes);
+#endif
 
         return result;
     }
 
     void SimpleAlloc::deallocate(pointer begin) {
+#ifdef ST_ALLOC_STATS
+        if(!begin)
+            return;
+        begin = (char*)begin - _STATS_HEADER;
+        size_type nbytes = *(size_type*)begin;
+        stats().record_dealloc(alloc_stats::pow2_class(nbytes), nbytes, nbytes);
+#endif
         free(begin);
     }
 
+//Blocks of every Alloc are aligned to at least _ALLOC_ALIGN bytes
+enum {_ALLOC_ALIGN = 16};
+
+template <class Alloc>
+    struct alloc_alignment {
+        enum {value = _ALLOC_ALIGN};
+    };
+
+//Blocks aligned beyond what an Alloc gives: Align more bytes are asked for
+//and the distance back to the Alloc's block is kept in the word in front
+//of the returned pointer.
+template <size_t Align>
+    struct _over_aligned {
+        static char* align_up (char* raw) {
+            return (char*)(((size_t)raw + sizeof(size_t) + Align - 1) & ~(size_t)(Align - 1));
+        }
+        static size_t& offset (void* p) { return ((size_t*)p)[-1]; }
+        static void* base (void* p) { return (char*)p - offset(p); }
+
+        template <class Alloc>
+        static void* allocate (Alloc& a, size_t nbytes) {
+            char* raw = (char*) a.allocate (nbytes + Align);
+            char* p = align_up (raw);
+            offset (p) = p - raw;
+            return p;
+        }
+
+        template <class Alloc>
+        static void deallocate (Alloc& a, void* p) {
+            if (p) a.deallocate (base (p));
+        }
+
+        //the new block may be aligned differently, the contents then slide
+        template <class Alloc>
+        static void* reallocate (Alloc& a, void* p, size_t nbytes) {
+            if (!p) return allocate (a, nbytes);
+            size_t old_offset = offset (p);
+            char* raw = (char*) a.reallocate (base (p), nbytes + Align);
+            char* result = align_up (raw);
+            if ((size_t)(result - raw) != old_offset)
+                memmove (result, raw + old_offset, nbytes);
+            offset (result) = result - raw;
+            return result;
+        }
+    };
+
+//Alloc adaptor whose blocks are aligned to Align bytes, such as
+//vector<T, aligned<64> > for buffers starting on a cache line
+template <size_t Align, class Alloc = SimpleAlloc>
+    class aligned : private Alloc {
+        static_assert ((Align & (Align - 1)) == 0, "alignment must be a power of two");
+        typedef _over_aligned<Align>    over_aligned;
+        enum {_PASS = Align <= (size_t)alloc_alignment<Alloc>::value};
+
+        public:
+            typedef void           value_type;
+            typedef void*          pointer;
+            typedef size_t      size_type;
+            typedef ptrdiff_t   difference_type;
+
+            aligned () { }
+            aligned (const Alloc& a) : Alloc(a) { }
+
+            const Alloc& get_allocator () const { return *this; }
+
+            pointer allocate (size_type nbytes) {
+                if (_PASS) return Alloc::allocate (nbytes);
+                return over_aligned::allocate (static_cast<Alloc&>(*this), nbytes);
+            }
+
+            pointer reallocate (pointer begin, size_type nbytes) {
+                if (_PASS) return Alloc::reallocate (begin, nbytes);
+                return over_aligned::reallocate (static_cast<Alloc&>(*this), begin, nbytes);
+            }
+
+            void deallocate (pointer begin) {
+                if (_PASS) Alloc::deallocate (begin);
+                else over_aligned::deallocate (static_cast<Alloc&>(*this), begin);
+            }
+    };
+
+template <size_t Align, class Alloc>
+    struct alloc_alignment<aligned<Align, Alloc> > {
+        enum {value = Align > (size_t)alloc_alignment<Alloc>::value ? Align : (size_t)alloc_alignment<Alloc>::value};
+    };
+
+//Typed front end of an Alloc. Alloc may be stateless with static members
+//(SimpleAlloc) or carry per-instance state such as a pool pointer; it is
+//kept as a base so that an empty Alloc takes no space. Types aligned
+//beyond what the Alloc guarantees are allocated over-aligned.
 template <class T, class Alloc = SimpleAlloc>
-    class simple_alloc {
+    class simple_alloc : private Alloc {
+        private:
+            typedef _over_aligned<alignof(T)>   over_aligned;
+            enum {_OVER_ALIGNED = alignof(T) > (size_t)alloc_alignment<Alloc>::value};
+
+            Alloc& alloc () { return *this; }
+
         public:
-            static T* allocate (size_t n) {
-                return n == 0 ? 0 : (T*) Alloc::allocate(n * sizeof (T)); 
+            typedef Alloc   allocator_type;
+
+            simple_alloc () { }
+            simple_alloc (const Alloc& a) : Alloc(a) { }
+            template <class U>
+            simple_alloc (const simple_alloc<U, Alloc>& x) : Alloc(x.get_allocator()) { }
+
+            const Alloc& get_allocator () const { return *this; }
+
+            T* allocate (size_t n) {
+                if (n == 0) return 0;
+                T* result;
+                if (_OVER_ALIGNED) result = (T*) over_aligned::allocate (alloc(), n * sizeof (T));
+                else result = (T*) Alloc::allocate(n * sizeof (T)); 
+#ifdef ST_ALLOC_TRACE
+                alloc_trace_recorder::instance().record_alloc (result, n * sizeof (T));
+#endif
+                return result;
             }
             
-            static T* allocate () {
-                return (T*) Alloc::allocate (sizeof(T));
+            T* allocate () {
+                return allocate (1);
+            }
+
+            void deallocate (T* p) {
+#ifdef ST_ALLOC_TRACE
+                alloc_trace_recorder::instance().record_free (p);
+#endif
+                if (_OVER_ALIGNED) over_aligned::deallocate (alloc(), p);
+                else Alloc::deallocate (p);
             }
 
-            static void deallocate (T* p) {
-                Alloc::deallocate (p);
+            T* reallocate (T* p, size_t n) {
+                if (n == 0) return 0;
+#ifdef ST_ALLOC_TRACE
+                uint32_t id = alloc_trace_recorder::instance().detach (p);
+#endif
+                T* result;
+                if (_OVER_ALIGNED) result = (T*) over_aligned::reallocate (alloc(), p, n * sizeof (T));
+                else result = (T*) Alloc::reallocate (p, n * sizeof (T));
+#ifdef ST_ALLOC_TRACE
+                alloc_trace_recorder::instance().record_realloc (id, result, n * sizeof (T));
+#endif
+                return result;
             }
 
-            static T* reallocate (T* p, size_t n) {
-                return n == 0 ? 0 : (T*) Alloc::reallocate (p, n);
+            void swap_allocator (simple_alloc& x) {
+                Alloc tmp = *this;
+                static_cast<Alloc&>(*this) = x;
+                static_cast<Alloc&>(x) = tmp;
             }
     };
 
@@ -0,0 +1,152 @@
+#ifndef ST_ARENA_ALLOC_H
+#define ST_ARENA_ALLOC_H
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+namespace tinySTL {
+    //bump-pointer memory resource: deallocate does nothing, reset() gives
+    //every block back at once. Not thread safe.
+    class arena {
+    private:
+        struct block {
+            block*  next;
+            size_t  size;
+        };
+        //every allocation is preceded by its size, so reallocate can copy
+        enum {_ALIGN = 16};
+        enum {_HEADER = _ALIGN};
+
+        block*  blocks;
+        char*   cur;
+        char*   limit;
+        char*   last;
+        size_t  block_bytes;
+        size_t  reserved;
+
+        arena(const arena&);
+        arena& operator=(const arena&);
+
+        static size_t round_up(size_t bytes) {
+            return (bytes + _ALIGN - 1) & ~(size_t)(_ALIGN - 1);
+        }
+        static size_t& size_of(void* p) {
+            return *(size_t*)((char*)p - _HEADER);
+        }
+        //get a new block large enough for nbytes plus its header
+        void grow(size_t nbytes) {
+            size_t need = round_up(sizeof(block)) + _HEADER + nbytes;
+            size_t size = need > block_bytes ? need : block_bytes;
+            block* b = (block*)malloc(size);
+            if(!b) {
+                std::cerr<<"out of memory!"<<std::endl;
+                exit(1);
+            }
+            b->next = blocks;
+            b->size = size;
+            blocks = b;
+            reserved += size;
+            cur = (char*)b + round_up(sizeof(block));
+            limit = (char*)b + size;
+        }
+
+    public:
+        explicit arena(size_t block_size = 64 * 1024)
+            : blocks(0), cur(0), limit(0), last(0), block_bytes(block_size), reserved(0) {}
+        ~arena() { reset(); }
+
+        //Returns nbytes of storage aligned to 16 bytes
+        void* allocate(size_t nbytes) {
+            nbytes = round_up(nbytes);
+            if((size_t)(limit - cur) < _HEADER + nbytes)
+                grow(nbytes);
+            last = cur + _HEADER;
+            cur = last + nbytes;
+            size_of(last) = nbytes;
+            return last;
+        }
+        //memory is only reclaimed by reset()
+        void deallocate(void*) { }
+        //the most recent allocation grows in place, others are copied
+        void* reallocate(void* ptr, size_t nbytes) {
+            if(!ptr) return allocate(nbytes);
+            size_t old_size = size_of(ptr);
+            nbytes = round_up(nbytes);
+            if(nbytes <= old_size) return ptr;
+            if(ptr == last && (size_t)(limit - (char*)ptr) >= nbytes) {
+                size_of(ptr) = nbytes;
+                cur = (char*)ptr + nbytes;
+                return ptr;
+            }
+            void* result = allocate(nbytes);
+            memcpy(result, ptr, old_size);
+            return result;
+        }
+        //release every block
+        void reset() {
+            while(blocks) {
+                block* next = blocks->next;
+                free(blocks);
+                blocks = next;
+            }
+            cur = limit = last = 0;
+            reserved = 0;
+        }
+        //bytes held from malloc
+        size_t bytes_reserved() const { return reserved; }
+    };
+
+    //Alloc parameter for the containers, all users of one inst share an arena
+template <int inst>
+    class arena_alloc {
+    public:
+        typedef void           value_type;
+        typedef void*          pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+    public:
+        static arena& get_arena() {
+            static arena instance;
+            return instance;
+        }
+        static pointer allocate(size_type nbytes) {
+            return get_arena().allocate(nbytes);
+        }
+        static pointer reallocate(pointer begin, size_type nbytes) {
+            return get_arena().reallocate(begin, nbytes);
+        }
+        static void deallocate(pointer) { }
+        static void reset() {
+            get_arena().reset();
+        }
+    };
+
+    //stateful Alloc: each instance draws from the arena it was given, so
+    //containers built with different arenas keep separate memory
+    class arena_ref {
+    public:
+        typedef void           value_type;
+        typedef void*          pointer;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+    private:
+        arena*  pool;
+
+    public:
+        arena_ref () : pool(0) { }
+        arena_ref (arena& a) : pool(&a) { }
+
+        arena* get_arena () const { return pool; }
+        pointer allocate (size_type nbytes) {
+            return pool->allocate(nbytes);
+        }
+        pointer reallocate (pointer begin, size_type nbytes) {
+            return pool->reallocate(begin, nbytes);
+        }
+        void deallocate (pointer) { }
+    };
+}
+#endif // ST_ARENA_ALLOC_H
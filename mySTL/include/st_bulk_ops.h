@@ -0,0 +1,96 @@
+#ifndef ST_BULK_OPS_H
+#define ST_BULK_OPS_H
+#include <stddef.h>
+#include <string.h>
+#include "st_typetrait.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+//Kernels behind the algorithms for contiguous ranges of trivially
+//assignable elements. They work on raw bytes; the callers decide when
+//that is allowed.
+
+namespace tinySTL {
+    //fill sizes that the pattern kernel handles, a 16 byte register holds
+    //a whole number of values
+    template <size_t Size> struct _pattern_fillable { typedef _false_type type; };
+    template <> struct _pattern_fillable<1> { typedef _true_type type; };
+    template <> struct _pattern_fillable<2> { typedef _true_type type; };
+    template <> struct _pattern_fillable<4> { typedef _true_type type; };
+    template <> struct _pattern_fillable<8> { typedef _true_type type; };
+    template <> struct _pattern_fillable<16> { typedef _true_type type; };
+
+    //fills above this go around the cache, the data would not fit anyway
+    enum {_STREAM_FILL_BYTES = 8 * 1024 * 1024};
+
+    //n values of Size bytes at dst, all copies of the bytes at value
+    template <size_t Size>
+    inline void _pattern_fill (void* dst, const void* value, size_t n) {
+        if (Size == 1) {
+            memset (dst, *(const unsigned char*)value, n);
+            return;
+        }
+        unsigned char pattern[16];
+        for (size_t i = 0; i < 16; i += Size)
+            memcpy (pattern + i, value, Size);
+        unsigned char* p = (unsigned char*)dst;
+        size_t bytes = n * Size;
+#if defined(__SSE2__)
+        __m128i v = _mm_loadu_si128 ((const __m128i*)pattern);
+        size_t head = (16 - (size_t)p % 16) % 16;
+        if (bytes >= _STREAM_FILL_BYTES && head % Size == 0) {
+            //the head is whole values, so the pattern keeps its phase
+            memcpy (p, pattern, head);
+            p += head;
+            bytes -= head;
+            for (; bytes >= 64; bytes -= 64, p += 64) {
+                _mm_stream_si128 ((__m128i*)p, v);
+                _mm_stream_si128 ((__m128i*)(p + 16), v);
+                _mm_stream_si128 ((__m128i*)(p + 32), v);
+                _mm_stream_si128 ((__m128i*)(p + 48), v);
+            }
+            _mm_sfence ();
+        }
+        for (; bytes >= 64; bytes -= 64, p += 64) {
+            _mm_storeu_si128 ((__m128i*)p, v);
+            _mm_storeu_si128 ((__m128i*)(p + 16), v);
+            _mm_storeu_si128 ((__m128i*)(p + 32), v);
+            _mm_storeu_si128 ((__m128i*)(p + 48), v);
+        }
+        for (; bytes >= 16; bytes -= 16, p += 16)
+            _mm_storeu_si128 ((__m128i*)p, v);
+#else
+        for (; bytes >= 16; bytes -= 16, p += 16)
+            memcpy (p, pattern, 16);
+#endif
+        memcpy (p, pattern, bytes);
+    }
+
+    template <class T>
+    inline void _bulk_fill_aux (T* first, size_t n, const T& x, _true_type) {
+        _pattern_fill<sizeof(T)> ((void*)first, (const void*)&x, n);
+    }
+
+    template <class T>
+    inline void _bulk_fill_aux (T* first, size_t n, const T& x, _false_type) {
+        for (; n > 0; --n, ++first)
+            *first = x;
+    }
+
+    //fill [first, first + n) with x; single bytes go to memset, values
+    //that tile a 16 byte register to the pattern kernel
+    template <class T>
+    inline void _bulk_fill (T* first, size_t n, const T& x) {
+        typedef typename _pattern_fillable<sizeof(T)>::type _fillable;
+        _bulk_fill_aux (first, n, x, _fillable());
+    }
+
+    //copy n elements, the ranges may overlap
+    template <class T>
+    inline T* _bulk_copy (const T* first, size_t n, T* result) {
+        if (n) memmove ((void*)result, (const void*)first, n * sizeof(T));
+        return result + n;
+    }
+}
+#endif // ST_BULK_OPS_H
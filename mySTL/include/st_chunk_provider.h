@@ -0,0 +1,63 @@
+#ifndef ST_CHUNK_PROVIDER_H
+#define ST_CHUNK_PROVIDER_H
+#include <stddef.h>
+#include <stdlib.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+namespace tinySTL {
+    //Source of the large regions the pools cut objects from. Requests are
+    //rounded up to granularity by the caller; acquire returns 0 on failure.
+    struct chunk_provider {
+        const char* name;
+        size_t      granularity;
+        void*       (*acquire)(size_t bytes);
+        void        (*release)(void* p, size_t bytes);
+    };
+
+    inline void* malloc_chunk_acquire(size_t bytes) { return malloc(bytes); }
+    inline void malloc_chunk_release(void* p, size_t) { free(p); }
+
+    //regions from malloc, the default
+    inline const chunk_provider& malloc_chunks() {
+        static const chunk_provider provider = {"malloc", 8, malloc_chunk_acquire, malloc_chunk_release};
+        return provider;
+    }
+
+#if defined(MAP_ANONYMOUS)
+    enum {_HUGE_PAGE = 2 * 1024 * 1024};
+
+    //map one extra huge page and cut the region down to a 2MiB boundary
+    inline void* mmap_chunk_acquire(size_t bytes) {
+        char* raw = (char*)mmap(0, bytes + _HUGE_PAGE, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(raw == (char*)MAP_FAILED) return 0;
+        char* p = (char*)(((size_t)raw + _HUGE_PAGE - 1) & ~(size_t)(_HUGE_PAGE - 1));
+        if(p != raw)
+            munmap(raw, p - raw);
+        munmap(p + bytes, raw + _HUGE_PAGE - p);
+#ifdef MADV_HUGEPAGE
+        //fails when the kernel has no transparent huge pages, the region
+        //then simply stays on normal pages
+        madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+        return p;
+    }
+    inline void mmap_chunk_release(void* p, size_t bytes) { munmap(p, bytes); }
+
+    //2MiB aligned anonymous mappings, asking for transparent huge pages
+    inline const chunk_provider& mmap_chunks() {
+        static const chunk_provider provider = {"mmap", _HUGE_PAGE, mmap_chunk_acquire, mmap_chunk_release};
+        return provider;
+    }
+#else
+    //no mmap on this platform
+    inline const chunk_provider& mmap_chunks() { return malloc_chunks(); }
+#endif
+
+    inline size_t round_to_granularity(const chunk_provider& p, size_t bytes) {
+        return (bytes + p.granularity - 1) / p.granularity * p.granularity;
+    }
+}
+#endif // ST_CHUNK_PROVIDER_H
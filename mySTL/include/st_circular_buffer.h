@@ -0,0 +1,393 @@
+#ifndef ST_CIRCULAR_BUFFER_H
+#define ST_CIRCULAR_BUFFER_H
+#include "st_iterator.h"
+#include "st_allocator.h"
+#include "st_algorithm.h"
+#include "st_uninitialled.h"
+#include "st_growth_policy.h"
+#include "st_pair.h"
+#include <assert.h>
+
+namespace tinySTL {
+    //Growth policy of a circular_buffer that never grows: a push into a full
+    //buffer overwrites the element at the other end, which slides a window
+    struct overwrite_oldest { };
+
+template <class Growth>
+    struct _overwrites {
+        typedef _false_type     type;
+    };
+
+template <>
+    struct _overwrites<overwrite_oldest> {
+        typedef _true_type      type;
+    };
+
+    //Logical position idx of a buffer whose first element sits at slot
+    //first. Past the last slot the positions go on at slot 0, there are at
+    //most two contiguous runs.
+template <class T, class Ptr, class Ref>
+    class circular_iterator {
+    public:
+        typedef random_access_iterator_tag  iterator_category;
+        typedef T                           value_type;
+        typedef Ptr                         pointer;
+        typedef Ref                         reference;
+        typedef size_t                      size_type;
+        typedef ptrdiff_t                   difference_type;
+
+        typedef circular_iterator<T, T*, T&>    iterator;
+        typedef circular_iterator               self;
+
+        T*          buf;
+        size_type   cap;
+        size_type   first;
+        size_type   idx;
+
+        circular_iterator () : buf(0), cap(0), first(0), idx(0) { }
+        circular_iterator (T* buf, size_type cap, size_type first, size_type idx)
+            : buf(buf), cap(cap), first(first), idx(idx) { }
+        //a const_iterator from an iterator
+        circular_iterator (const iterator& x) : buf(x.buf), cap(x.cap), first(x.first), idx(x.idx) { }
+
+        //slot of the element, may be cap for the end of a full run
+        size_type slot () const {
+            size_type s = first + idx;
+            return s >= cap && cap ? s - cap : s;
+        }
+        //0 on the run from first to the last slot, 1 on the run from slot 0
+        size_type lap () const { return first + idx >= cap && cap ? 1 : 0; }
+
+        reference operator* () const { return buf[slot()]; }
+        pointer operator-> () const { return &(operator*()); }
+        reference operator[] (difference_type n) const { return *(*this + n); }
+
+        self& operator++ () { ++idx; return *this; }
+        self operator++ (int) { self tmp = *this; ++idx; return tmp; }
+        self& operator-- () { --idx; return *this; }
+        self operator-- (int) { self tmp = *this; --idx; return tmp; }
+        self& operator+= (difference_type n) { idx += n; return *this; }
+        self& operator-= (difference_type n) { idx -= n; return *this; }
+        self operator+ (difference_type n) const { self tmp = *this; return tmp += n; }
+        self operator- (difference_type n) const { self tmp = *this; return tmp -= n; }
+        difference_type operator- (const self& x) const { return difference_type(idx - x.idx); }
+
+        bool operator== (const self& x) const { return idx == x.idx; }
+        bool operator!= (const self& x) const { return idx != x.idx; }
+        bool operator< (const self& x) const { return idx < x.idx; }
+        bool operator> (const self& x) const { return idx > x.idx; }
+        bool operator<= (const self& x) const { return idx <= x.idx; }
+        bool operator>= (const self& x) const { return idx >= x.idx; }
+    };
+
+    //one of the two runs of a circular buffer, both span the whole array
+template <class T>
+    struct _circular_segment {
+        T*          buf;
+        size_t      cap;
+        size_t      lap;
+
+        _circular_segment& operator++ () { ++lap; return *this; }
+        _circular_segment& operator-- () { --lap; return *this; }
+        bool operator== (const _circular_segment& x) const { return lap == x.lap; }
+        bool operator!= (const _circular_segment& x) const { return lap != x.lap; }
+    };
+
+    //copy, fill, equal and the rest walk the two runs with plain pointers
+template <class T, class Ptr, class Ref>
+    struct segmented_iterator_traits<circular_iterator<T, Ptr, Ref> > {
+        typedef _true_type                          is_segmented_iterator;
+        typedef circular_iterator<T, Ptr, Ref>      iterator;
+        typedef _circular_segment<T>                segment_iterator;
+        typedef Ptr                                 local_iterator;
+
+        static segment_iterator segment (const iterator& it) {
+            segment_iterator seg = {it.buf, it.cap, it.lap()};
+            return seg;
+        }
+        static local_iterator local (const iterator& it) { return it.buf + it.slot(); }
+        static local_iterator begin (segment_iterator seg) { return seg.buf; }
+        static local_iterator end (segment_iterator seg) { return seg.buf + seg.cap; }
+    };
+
+    //Random access sequence in one array of capacity() slots, the elements
+    //run from the first slot in use to the end of the array and go on at
+    //its start. Pushes and pops at both ends move no other element and
+    //allocate nothing until the buffer grows. array_one() and array_two()
+    //hand out the two contiguous runs for memcpy or vectorized loops.
+    //Growth is a vector growth policy, or overwrite_oldest for a buffer of
+    //fixed capacity.
+template <class T, class Alloc = SimpleAlloc, class Growth = grow_double>
+    class circular_buffer : private simple_alloc<T, Alloc> {
+    private:
+        typedef simple_alloc<T, Alloc>          data_allocator_type;
+        typedef typename _overwrites<Growth>::type  _overwrite;
+
+    public:
+        typedef T                   value_type;
+        typedef T*                  pointer;
+        typedef const T*            const_pointer;
+        typedef T&                  reference;
+        typedef const T&            const_reference;
+        typedef size_t              size_type;
+        typedef ptrdiff_t           difference_type;
+        typedef circular_iterator<T, T*, T&>                iterator;
+        typedef circular_iterator<T, const T*, const T&>    const_iterator;
+        //a contiguous run of elements and its length
+        typedef pair<pointer, size_type>            array_range;
+        typedef pair<const_pointer, size_type>      const_array_range;
+
+    private:
+        T*          _buf;
+        size_type   _cap;
+        size_type   _first;
+        size_type   _size;
+
+        data_allocator_type& data_allocator () { return *this; }
+        //slot of the logical position i, i <= capacity()
+        size_type slot (size_type i) const {
+            size_type s = _first + i;
+            return s >= _cap ? s - _cap : s;
+        }
+        size_type prev_slot (size_type s) const { return s == 0 ? _cap - 1 : s - 1; }
+        //move the elements to a new array of newcap >= size() slots, the first at slot 0
+        void relocate (size_type newcap) {
+            T* result = data_allocator().allocate (newcap);
+            size_type one = _cap - _first < _size ? _cap - _first : _size;
+            T* cur = uninitialed_move (_buf + _first, _buf + _first + one, result);
+            uninitialed_move (_buf, _buf + (_size - one), cur);
+            destroy_all ();
+            data_allocator().deallocate (_buf);
+            _buf = result;
+            _cap = newcap;
+            _first = 0;
+        }
+        void destroy_all () {
+            size_type one = _cap - _first < _size ? _cap - _first : _size;
+            destroy (_buf + _first, _buf + _first + one);
+            destroy (_buf, _buf + (_size - one));
+        }
+        //copy the elements of x into an empty buffer with room for them
+        void copy_from (const circular_buffer& x) {
+            const_array_range one = x.array_one(), two = x.array_two();
+            T* cur = uninitialed_copy (one.first, one.first + one.second, _buf);
+            uninitialed_copy (two.first, two.first + two.second, cur);
+            _first = 0;
+            _size = x._size;
+        }
+
+        //a full buffer either grows or reuses the slot at the other end.
+        //The element is built first, args may refer to one in the buffer
+        template <class... Args>
+        void emplace_back_full (_false_type, Args&&... args) {
+            value_type tmp (std::forward<Args>(args)...);
+            relocate (Growth::grow (_cap, _size + 1, sizeof(T)));
+            construct (_buf + slot (_size), std::move (tmp));
+            ++_size;
+        }
+        template <class... Args>
+        void emplace_back_full (_true_type, Args&&... args) {
+            if (_cap == 0) return;
+            _buf[_first] = value_type (std::forward<Args>(args)...);
+            _first = slot (1);
+        }
+        template <class... Args>
+        void emplace_front_full (_false_type, Args&&... args) {
+            value_type tmp (std::forward<Args>(args)...);
+            relocate (Growth::grow (_cap, _size + 1, sizeof(T)));
+            _first = prev_slot (0);
+            construct (_buf + _first, std::move (tmp));
+            ++_size;
+        }
+        template <class... Args>
+        void emplace_front_full (_true_type, Args&&... args) {
+            if (_cap == 0) return;
+            _first = prev_slot (_first);
+            _buf[_first] = value_type (std::forward<Args>(args)...);
+        }
+
+    public:
+        //an empty buffer, it allocates on the first push
+        circular_buffer () : _buf(0), _cap(0), _first(0), _size(0) { }
+        //an empty buffer with capacity slots
+        explicit circular_buffer (size_type capacity, const Alloc& a = Alloc())
+            : data_allocator_type(a), _cap(capacity), _first(0), _size(0) {
+                _buf = data_allocator().allocate (capacity);
+            }
+        //n copies of x in a buffer of capacity n
+        circular_buffer (size_type n, const value_type& x, const Alloc& a = Alloc())
+            : data_allocator_type(a), _cap(n), _first(0), _size(n) {
+                _buf = data_allocator().allocate (n);
+                _uninitialed_fill_n (_buf, n, x);
+            }
+        //the copy has the capacity and the allocator of x, its elements start at slot 0
+        circular_buffer (const circular_buffer& x)
+            : data_allocator_type(x.get_allocator()), _cap(x._cap) {
+                _buf = data_allocator().allocate (_cap);
+                copy_from (x);
+            }
+        //takes over the array and the allocator of x, which is left empty
+        circular_buffer (circular_buffer&& x)
+            : data_allocator_type(x.get_allocator()), _buf(x._buf), _cap(x._cap),
+              _first(x._first), _size(x._size) {
+                x._buf = 0;
+                x._cap = x._first = x._size = 0;
+            }
+        ~circular_buffer () {
+            destroy_all ();
+            data_allocator().deallocate (_buf);
+        }
+        circular_buffer& operator= (const circular_buffer& x) {
+            if (this == &x) return *this;
+            clear ();
+            if (_cap != x._cap) {
+                data_allocator().deallocate (_buf);
+                _buf = data_allocator().allocate (x._cap);
+                _cap = x._cap;
+            }
+            copy_from (x);
+            return *this;
+        }
+        circular_buffer& operator= (circular_buffer&& x) {
+            circular_buffer tmp (std::move (x));
+            swap (tmp);
+            return *this;
+        }
+
+        //Returns an iterator pointing to the first element
+        iterator begin () { return iterator (_buf, _cap, _first, 0); }
+        const_iterator begin () const { return const_iterator (_buf, _cap, _first, 0); }
+        const_iterator cbegin () const { return begin(); }
+        //Returns an iterator referring to the past-the-end element
+        iterator end () { return iterator (_buf, _cap, _first, _size); }
+        const_iterator end () const { return const_iterator (_buf, _cap, _first, _size); }
+        const_iterator cend () const { return end(); }
+
+        size_type size () const { return _size; }
+        bool empty () const { return _size == 0; }
+        //true when the next push grows the buffer or overwrites an element
+        bool full () const { return _size == _cap; }
+        size_type capacity () const { return _cap; }
+        size_type max_size () const { return size_type(-1) / sizeof(value_type); }
+        //Returns a copy of the allocator object associated with the buffer
+        Alloc get_allocator () const { return data_allocator_type::get_allocator(); }
+
+        //Returns a reference to the element at logical position i
+        reference operator[] (size_type i) { return _buf[slot (i)]; }
+        const_reference operator[] (size_type i) const { return _buf[slot (i)]; }
+        reference at (size_type i) { assert (i < _size); return _buf[slot (i)]; }
+        const_reference at (size_type i) const { assert (i < _size); return _buf[slot (i)]; }
+        reference front () { return _buf[_first]; }
+        const_reference front () const { return _buf[_first]; }
+        reference back () { return _buf[slot (_size - 1)]; }
+        const_reference back () const { return _buf[slot (_size - 1)]; }
+
+        //the elements from the front up to the end of the array, or all of
+        //them when they do not wrap
+        array_range array_one () {
+            return array_range (_buf + _first, _cap - _first < _size ? _cap - _first : _size);
+        }
+        const_array_range array_one () const {
+            return const_array_range (_buf + _first, _cap - _first < _size ? _cap - _first : _size);
+        }
+        //the elements that wrapped to the start of the array, maybe none
+        array_range array_two () {
+            return array_range (_buf, _cap - _first < _size ? _size - (_cap - _first) : 0);
+        }
+        const_array_range array_two () const {
+            return const_array_range (_buf, _cap - _first < _size ? _size - (_cap - _first) : 0);
+        }
+        //moves the elements so that array_one() holds all of them, returns it
+        pointer linearize () {
+            if (_cap - _first < _size)
+                relocate (_cap);
+            return _buf + _first;
+        }
+
+        //Add element at the end
+        void push_back (const value_type& x) { emplace_back (x); }
+        void push_back (value_type&& x) { emplace_back (std::move (x)); }
+        template <class... Args>
+        void emplace_back (Args&&... args) {
+            if (_size == _cap) {
+                emplace_back_full (_overwrite(), std::forward<Args>(args)...);
+                return;
+            }
+            construct (_buf + slot (_size), std::forward<Args>(args)...);
+            ++_size;
+        }
+        //Add element at the front
+        void push_front (const value_type& x) { emplace_front (x); }
+        void push_front (value_type&& x) { emplace_front (std::move (x)); }
+        template <class... Args>
+        void emplace_front (Args&&... args) {
+            if (_size == _cap) {
+                emplace_front_full (_overwrite(), std::forward<Args>(args)...);
+                return;
+            }
+            size_type s = prev_slot (_first);
+            construct (_buf + s, std::forward<Args>(args)...);
+            _first = s;
+            ++_size;
+        }
+        //erase the element at the end
+        void pop_back () {
+            assert (_size != 0);
+            --_size;
+            destroy (_buf + slot (_size));
+        }
+        //erase the element at the front
+        void pop_front () {
+            assert (_size != 0);
+            destroy (_buf + _first);
+            _first = slot (1);
+            --_size;
+        }
+        //Removes all elements, the capacity stays
+        void clear () {
+            destroy_all ();
+            _first = _size = 0;
+        }
+        //capacity be at least n, the elements move to the start of the array
+        void reserve (size_type n) {
+            if (_cap < n)
+                relocate (n);
+        }
+        //capacity be exactly n; when n < size() the elements at the front go
+        void set_capacity (size_type n) {
+            while (_size > n)
+                pop_front ();
+            if (_cap != n)
+                relocate (n);
+        }
+        //Exchanges the content of the container by the content of x, allocators included
+        void swap (circular_buffer& x) {
+            data_allocator().swap_allocator (x.data_allocator());
+            tinySTL::swap (_buf, x._buf);
+            tinySTL::swap (_cap, x._cap);
+            tinySTL::swap (_first, x._first);
+            tinySTL::swap (_size, x._size);
+        }
+    };
+
+    //comparison operation between the circular_buffer containers x and y
+template <class T, class Alloc, class Growth>
+    inline bool operator== (const circular_buffer<T, Alloc, Growth>& x, const circular_buffer<T, Alloc, Growth>& y) {
+        return x.size() == y.size() && tinySTL::equal (x.begin(), x.end(), y.begin());
+    }
+template <class T, class Alloc, class Growth>
+    inline bool operator!= (const circular_buffer<T, Alloc, Growth>& x, const circular_buffer<T, Alloc, Growth>& y) {
+        return !(x == y);
+    }
+template <class T, class Alloc, class Growth>
+    inline bool operator< (const circular_buffer<T, Alloc, Growth>& x, const circular_buffer<T, Alloc, Growth>& y) {
+        return tinySTL::lexicographical_compare (x.begin(), x.end(), y.begin(), y.end());
+    }
+    //The contents of container x are exchanged with those of y
+template <class T, class Alloc, class Growth>
+    inline void swap (circular_buffer<T, Alloc, Growth>& x, circular_buffer<T, Alloc, Growth>& y) {
+        x.swap (y);
+    }
+}
+
+#endif
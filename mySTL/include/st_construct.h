@@ -4,17 +4,14 @@
 #include "st_typetrait.h"
 #include "st_iterator.h"
 #include <new>
+#include <utility>
 
 namespace tinySTL {
     
-    template <class T1, class T2>
-    inline void construct(T1* ptr, const T2& value) {
-        new (ptr) T1(value);
-    }
-
-    template <class T1>
-    inline void construct(T1* ptr) {
-        new (ptr) T1();
+    //construct a T1 in place from any constructor arguments
+    template <class T1, class... Args>
+    inline void construct(T1* ptr, Args&&... args) {
+        new (ptr) T1(std::forward<Args>(args)...);
     }
 
     template <class T1>
@@ -33,8 +30,8 @@ namespace tinySTL {
 
     template <class ForwardIterator, class T>
     inline void _destroy(ForwardIterator start, ForwardIterator end, T*) {
-        typedef typename _type_traits<T>::is_POD_type _is_POD_type;
-        _destroy_aux(start, end, _is_POD_type());
+        typedef typename _type_traits<T>::has_trivial_destructor _trivial_destructor;
+        _destroy_aux(start, end, _trivial_destructor());
     }
 
     template <class ForwardIterator>
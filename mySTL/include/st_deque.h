@@ -8,16 +8,31 @@
 
 namespace tinySTL {
 
-inline size_t _deque_buf_size (size_t sz) {
-    return sz < 521 ? size_t ( 512 / sz ) : size_t (1);
-}
-template <class T, class Ptr, class Ref>
+//default byte budget of a deque buffer
+enum {_DEQUE_BUF_BYTES = 4096};
+
+//a buffer holds the largest power of two of elements that fits in Bytes,
+//at least one, value is its log2
+template <size_t Size, size_t Bytes, bool Doubles = (Size * 2 <= Bytes)>
+struct _deque_buf_shift {
+    enum {value = 1 + _deque_buf_shift<Size * 2, Bytes>::value};
+};
+
+template <size_t Size, size_t Bytes>
+struct _deque_buf_shift<Size, Bytes, false> {
+    enum {value = 0};
+};
+
+template <class T, class Ptr, class Ref, size_t BufBytes = _DEQUE_BUF_BYTES>
 class deque_iterator {
-    protected:
-        typedef deque_iterator<T, T*, T&> iterator;
-        typedef const deque_iterator<T, T*, T&> const_iterator;
+    public:
+        typedef deque_iterator<T, T*, T&, BufBytes> iterator;
+        typedef const deque_iterator<T, T*, T&, BufBytes> const_iterator;
+        //positions in a buffer split with shifts and masks
+        enum {_BUF_SHIFT = _deque_buf_shift<sizeof(T), BufBytes>::value};
+        enum {_BUF_MASK = (1 << _BUF_SHIFT) - 1};
         //data buffer size
-        static size_t buffer_size () { return _deque_buf_size (sizeof(T)); }
+        static size_t buffer_size () { return size_t (1) << _BUF_SHIFT; }
 
         typedef random_access_iterator_tag  iterator_category;
         typedef T                           value_type;
@@ -61,7 +76,7 @@ class deque_iterator {
             return *this;
         }
 
-        self& operator++ (int) {
+        self operator++ (int) {
             self tmp = *this;
             ++(*this);
             return tmp;
@@ -76,43 +91,42 @@ class deque_iterator {
             return *this;
         }
 
-        self& operator-- (int) {
+        self operator-- (int) {
             self tmp = *this;
             --*this;
             return tmp;
         }
 
-        self operator+= (difference_type size) {
-            difference_type buf_size = buffer_size();
-            difference_type slack = size - (last - cur);
-            difference_type buf_num = (slack + buf_size) / buf_size;
-            if (buf_num > 0) {
-                set_node (node + buf_num);
-                cur = first + slack - (buf_num - 1) * buf_size;
-            } else {
+        self& operator+= (difference_type size) {
+            difference_type offset = size + (cur - first);
+            if ((size_type)offset < buffer_size()) {
                 cur += size;
+            } else {
+                //the shift rounds down for negative offsets too
+                set_node (node + (offset >> _BUF_SHIFT));
+                cur = first + (offset & _BUF_MASK);
             }
             return *this;
         }
 
-        self operator+ (difference_type size) {
+        self operator+ (difference_type size) const {
             self tmp = *this;
             tmp += size;
             return tmp;
         }                           
 
-        self operator-= (difference_type size) {
+        self& operator-= (difference_type size) {
             return (*this) += -size;
         }
 
-        self operator- (difference_type size) {
+        self operator- (difference_type size) const {
             self tmp = *this;
             tmp -= size;
             return tmp;
         }
 
 
-        reference operator[] (difference_type n) {
+        reference operator[] (difference_type n) const {
             return *(*this + n);
         }
         //overload relationships of iterator   
@@ -124,9 +138,23 @@ class deque_iterator {
         bool operator>= ( const self& x) const { return *this > x || *this == x; }
 };
 
-//default use simpleAlloc
-template <class T, class Alloc = SimpleAlloc>
-    class deque {
+//the buffers of a deque are its segments, the map walks them
+template <class T, class Ptr, class Ref, size_t BufBytes>
+struct segmented_iterator_traits<deque_iterator<T, Ptr, Ref, BufBytes> > {
+    typedef _true_type                              is_segmented_iterator;
+    typedef deque_iterator<T, Ptr, Ref, BufBytes>   iterator;
+    typedef T**                             segment_iterator;
+    typedef Ptr                             local_iterator;
+
+    static segment_iterator segment (const iterator& it) { return it.node; }
+    static local_iterator local (const iterator& it) { return it.cur; }
+    static local_iterator begin (segment_iterator seg) { return *seg; }
+    static local_iterator end (segment_iterator seg) { return *seg + iterator::buffer_size(); }
+};
+
+//default use simpleAlloc, BufBytes is the byte budget of one buffer
+template <class T, class Alloc = SimpleAlloc, size_t BufBytes = _DEQUE_BUF_BYTES>
+    class deque : private simple_alloc<T, Alloc> {
         private:
             typedef T   value_type;
             typedef T*  pointer;
@@ -136,8 +164,8 @@ template <class T, class Alloc = SimpleAlloc>
             typedef size_t  size_type;
             typedef ptrdiff_t    difference_type;
         public:
-            typedef deque_iterator<value_type, pointer, reference> iterator;
-            typedef const deque_iterator<T, T*, T&> const_iterator;
+            typedef deque_iterator<value_type, pointer, reference, BufBytes> iterator;
+            typedef const deque_iterator<T, T*, T&, BufBytes> const_iterator;
         
         protected:
             //map pointer
@@ -149,25 +177,42 @@ template <class T, class Alloc = SimpleAlloc>
 
             map_pointer map;
             size_type map_size;
-            //two different allocator
-            simple_alloc<value_type, Alloc>   data_allocator;
-            simple_alloc<pointer, Alloc>      map_allocator;
+            //buffers freed at one end are kept for the other end, so a
+            //deque used as a queue stops allocating once it is warm
+            enum {_SPARE_NODES = 2};
+            pointer spare_nodes[_SPARE_NODES];
+            size_type spare_count;
+            //two different allocator, both made from the Alloc kept in the base
+            typedef simple_alloc<value_type, Alloc>   data_allocator_type;
+            typedef simple_alloc<pointer, Alloc>      map_allocator_type;
+            data_allocator_type& data_allocator () { return *this; }
+            map_allocator_type map_allocator () const { return map_allocator_type (get_allocator()); }
         private:
             //return buffer size
-            size_type buf_size () const { return _deque_buf_size (sizeof (T)); }
-            //allocate a new node
+            size_type buf_size () const { return iterator::buffer_size(); }
+            //allocate a new node, a spare one if there is
             pointer allocate_node () {
-                return data_allocator.allocate(buf_size());
+                if (spare_count)
+                    return spare_nodes[--spare_count];
+                return data_allocator().allocate(buf_size());
             }
-            //deallocate a node buffer
+            //deallocate a node buffer, or keep it as a spare
             void deallocate_node (pointer buff_ptr) {
-                data_allocator.deallocate (buff_ptr);
+                if (spare_count < _SPARE_NODES)
+                    spare_nodes[spare_count++] = buff_ptr;
+                else
+                    data_allocator().deallocate (buff_ptr);
+            }
+            //give the spare buffers back to the allocator
+            void release_spare_nodes () {
+                while (spare_count)
+                    data_allocator().deallocate (spare_nodes[--spare_count]);
             }
             //create a new node and map
             void create_map_and_node (const size_type& num_elems) {
                 size_type node_num = num_elems / buf_size() + 1;
                 map_size = max((size_type)8, node_num+2);
-                map = map_allocator.allocate(map_size);
+                map = map_allocator().allocate(map_size);
                 map_pointer nstart = map + (map_size - node_num)/2;
                 map_pointer nend = nstart + node_num - 1;
                 for (map_pointer cur = nstart; cur != nend + 1; ++cur)
@@ -184,25 +229,28 @@ template <class T, class Alloc = SimpleAlloc>
                    uninitialled_fill (*tcur, *tcur + buf_size(), value);
                 uninitialled_fill (finish.first, finish.cur, value);
             }
-            //reallocate a map if the map need to expand
+            //make room for node_to_add nodes at one end: the live nodes are
+            //recentered in the map while it is at most half full, which keeps
+            //a sliding queue in the same map, and the map grows otherwise.
+            //The new nodes go on the side they are added at
             void reallocate_map (size_type node_to_add, bool add_front) {
                 size_type old_node_num = finish.node - start.node + 1;
                 size_type new_node_num = old_node_num + node_to_add;
                 map_pointer new_start;
                 if (map_size > 2 * new_node_num) {
                     new_start = map + (map_size - new_node_num) / 2
-                                    + (add_front?0:node_to_add);
+                                    + (add_front ? node_to_add : 0);
                     if (new_start < start.node)
-                        copy (start.node, finish.node + 1, new_start);
+                        tinySTL::copy (start.node, finish.node + 1, new_start);
                     else
-                        backward_copy (start.node, finish.node+1, new_start);
+                        tinySTL::backward_copy (start.node, finish.node+1, new_start + old_node_num - 1);
                 } else {
                     size_type new_map_size = map_size + max (map_size, new_node_num) + 2;
-                    map_pointer new_map = map_allocator.allocate (new_map_size);
+                    map_pointer new_map = map_allocator().allocate (new_map_size);
                     new_start = new_map + (new_map_size - new_node_num) / 2
-                                        + (add_front ? 0 : node_to_add);
-                    copy (start.node, finish.node+1, new_start);
-                    map_allocator.deallocate(map);
+                                        + (add_front ? node_to_add : 0);
+                    tinySTL::copy (start.node, finish.node+1, new_start);
+                    map_allocator().deallocate(map);
                     map = new_map;
                     map_size = new_map_size;
                 }
@@ -211,29 +259,59 @@ template <class T, class Alloc = SimpleAlloc>
             }
             //check if the map is empty at the end
             void reserve_map_at_back (size_type node_to_add = 1) {
-                if (node_to_add + 1 > map_size - (finish.node - start.node + 1) )
+                if (node_to_add + 1 > map_size - (finish.node - map))
                     reallocate_map (node_to_add, false);
             }
             //check if the map have enough space at the front
             void reserve_map_at_front (size_type node_to_add = 1) {
-                if (node_to_add > start.node - map) 
+                if (node_to_add > (size_type)(start.node - map))
                     reallocate_map (node_to_add, true);
             }
+            //allocate the buffers for new_elems elements before start
+            void new_elements_at_front (size_type new_elems) {
+                size_type new_nodes = (new_elems + buf_size() - 1) / buf_size();
+                reserve_map_at_front (new_nodes);
+                for (size_type i = 1; i <= new_nodes; ++i)
+                    *(start.node - i) = allocate_node ();
+            }
+            //allocate the buffers for new_elems elements after finish
+            void new_elements_at_back (size_type new_elems) {
+                size_type new_nodes = (new_elems + buf_size() - 1) / buf_size();
+                reserve_map_at_back (new_nodes);
+                for (size_type i = 1; i <= new_nodes; ++i)
+                    *(finish.node + i) = allocate_node ();
+            }
+            //make room for n elements before start, returns the new start
+            iterator reserve_elements_at_front (size_type n) {
+                size_type vacancies = start.cur - start.first;
+                if (n > vacancies)
+                    new_elements_at_front (n - vacancies);
+                return start - difference_type (n);
+            }
+            //make room for n elements after finish, returns the new finish
+            iterator reserve_elements_at_back (size_type n) {
+                size_type vacancies = (finish.last - finish.cur) - 1;
+                if (n > vacancies)
+                    new_elements_at_back (n - vacancies);
+                return finish + difference_type (n);
+            }
             //push_back element in the end 
-             void push_back_aux (const value_type& value) {
+             template <class... Args>
+             void push_back_aux (Args&&... args) {
                  reserve_map_at_back ();
-                 *(finish.node + 1) = data_allocator.allocate ();
-                 construct (finish.cur, value);
+                 *(finish.node + 1) = allocate_node ();
+                 construct (finish.cur, std::forward<Args>(args)...);
                  finish.set_node (finish.node + 1);
                  finish.cur = finish.first;
              }
             //push the element at the front
-             void push_front_aux ( const value_type& value) {
+             template <class... Args>
+             void push_front_aux (Args&&... args) {
                 reserve_map_at_front ();
-                *(start.node - 1) = data_allocator.allocate ();
+                *(start.node - 1) = allocate_node ();
                 start.set_node (start.node-1);
                 start.cur = start.last - 1;
-                construct (start.cur, value);
+                construct (start.cur, std::forward<Args>(args)...);
              }
              //remove the element at the back
              void pop_back_aux () {
@@ -250,27 +328,164 @@ template <class T, class Alloc = SimpleAlloc>
                 start.cur = start.first;
              }
             //insert the element while the element is not at the front or back
-             iterator insert_aux (iterator pos, const value_type& val) {
+             //the new element is built first, args may refer into the deque
+             template <class... Args>
+             iterator insert_aux (iterator pos, Args&&... args) {
+                value_type tmp (std::forward<Args>(args)...);
                 difference_type index = pos - start;
-                if (index < (size()>>1) ) {
-                    push_front(front());
+                if (index < (difference_type)(size()>>1) ) {
+                    //the old front now sits at start, its moved-from slot is the first to fill
+                    push_front(std::move(front()));
                     iterator old_front = start;
                     ++old_front;
+                    iterator front2 = old_front;
+                    ++front2;
                     pos = start + index; // update pos in case for overflow of map
                     iterator pos1 = pos;
                     ++pos1;
-                    copy (old_front, pos1, start);
+                    tinySTL::move (front2, pos1, old_front);
                 } else {
-                    push_back(back());
-                    iterator old_finish = finish;
-                    --old_finish;
+                    push_back(std::move(back()));
+                    iterator old_back = finish;
+                    --old_back;
+                    --old_back;
                     pos = start + index;
-                    backward_copy (pos, old_finish, old_finish);
+                    backward_move (pos, old_back, old_back);
                 }
-                *pos = val;
+                *pos = std::move(tmp);
                 return pos;
 
              }
+             //insert n copies of x before pos, on the shorter side of pos the
+             //elements move out by n, buffer by buffer for trivial types
+             void fill_insert_aux (iterator pos, size_type n, const value_type& x) {
+                value_type x_copy (x);
+                difference_type elems_before = pos - start;
+                size_type length = size ();
+                if (elems_before < (difference_type)(length / 2)) {
+                    iterator new_start = reserve_elements_at_front (n);
+                    iterator old_start = start;
+                    pos = start + elems_before;
+                    if (elems_before >= (difference_type)n) {
+                        iterator start_n = start + difference_type (n);
+                        uninitialed_move (start, start_n, new_start);
+                        start = new_start;
+                        tinySTL::move (start_n, pos, old_start);
+                        tinySTL::fill (pos - difference_type (n), pos, x_copy);
+                    } else {
+                        iterator mid = uninitialed_move (start, pos, new_start);
+                        uninitialled_fill (mid, old_start, x_copy);
+                        start = new_start;
+                        tinySTL::fill (old_start, pos, x_copy);
+                    }
+                } else {
+                    iterator new_finish = reserve_elements_at_back (n);
+                    iterator old_finish = finish;
+                    difference_type elems_after = difference_type (length) - elems_before;
+                    pos = finish - elems_after;
+                    if (elems_after > (difference_type)n) {
+                        iterator finish_n = finish - difference_type (n);
+                        uninitialed_move (finish_n, finish, finish);
+                        finish = new_finish;
+                        backward_move (pos, finish_n, old_finish - 1);
+                        tinySTL::fill (pos, pos + difference_type (n), x_copy);
+                    } else {
+                        uninitialled_fill (finish, pos + difference_type (n), x_copy);
+                        uninitialed_move (pos, finish, pos + difference_type (n));
+                        finish = new_finish;
+                        tinySTL::fill (pos, old_finish, x_copy);
+                    }
+                }
+             }
+             //insert the n elements of [first, last) before pos, the way
+             //fill_insert_aux does
+             template <class ForwardIterator>
+             void range_insert_aux (iterator pos, ForwardIterator first, ForwardIterator last, size_type n) {
+                difference_type elems_before = pos - start;
+                size_type length = size ();
+                if (elems_before < (difference_type)(length / 2)) {
+                    iterator new_start = reserve_elements_at_front (n);
+                    iterator old_start = start;
+                    pos = start + elems_before;
+                    if (elems_before >= (difference_type)n) {
+                        iterator start_n = start + difference_type (n);
+                        uninitialed_move (start, start_n, new_start);
+                        start = new_start;
+                        tinySTL::move (start_n, pos, old_start);
+                        tinySTL::copy (first, last, pos - difference_type (n));
+                    } else {
+                        ForwardIterator mid = first;
+                        tinySTL::advance (mid, difference_type (n) - elems_before);
+                        iterator cur = uninitialed_move (start, pos, new_start);
+                        uninitialed_copy (first, mid, cur);
+                        start = new_start;
+                        tinySTL::copy (mid, last, old_start);
+                    }
+                } else {
+                    iterator new_finish = reserve_elements_at_back (n);
+                    iterator old_finish = finish;
+                    difference_type elems_after = difference_type (length) - elems_before;
+                    pos = finish - elems_after;
+                    if (elems_after > (difference_type)n) {
+                        iterator finish_n = finish - difference_type (n);
+                        uninitialed_move (finish_n, finish, finish);
+                        finish = new_finish;
+                        backward_move (pos, finish_n, old_finish - 1);
+                        tinySTL::copy (first, last, pos);
+                    } else {
+                        ForwardIterator mid = first;
+                        tinySTL::advance (mid, elems_after);
+                        iterator cur = uninitialed_copy (mid, last, finish);
+                        uninitialed_move (pos, finish, cur);
+                        finish = new_finish;
+                        tinySTL::copy (first, mid, pos);
+                    }
+                }
+             }
+             //n copies of x, at either end they are built in the new room
+             void fill_insert (iterator pos, size_type n, const value_type& x) {
+                if (n == 0) return;
+                if (pos == start) {
+                    iterator new_start = reserve_elements_at_front (n);
+                    uninitialled_fill (new_start, start, x);
+                    start = new_start;
+                } else if (pos == finish) {
+                    iterator new_finish = reserve_elements_at_back (n);
+                    uninitialled_fill (finish, new_finish, x);
+                    finish = new_finish;
+                } else
+                    fill_insert_aux (pos, n, x);
+             }
+             //input iterators give one element at a time
+             template <class InputIterator>
+             void range_insert (iterator pos, InputIterator first, InputIterator last, input_iterator_tag) {
+                for (; first != last; ++first, ++pos)
+                    pos = insert (pos, *first);
+             }
+             template <class ForwardIterator>
+             void range_insert (iterator pos, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+                size_type n = tinySTL::distance (first, last);
+                if (n == 0) return;
+                if (pos == start) {
+                    iterator new_start = reserve_elements_at_front (n);
+                    uninitialed_copy (first, last, new_start);
+                    start = new_start;
+                } else if (pos == finish) {
+                    iterator new_finish = reserve_elements_at_back (n);
+                    uninitialed_copy (first, last, finish);
+                    finish = new_finish;
+                } else
+                    range_insert_aux (pos, first, last, n);
+             }
+             //insert (pos, 5, 3) means five threes, not a range
+             template <class Integer>
+             void insert_dispatch (iterator pos, Integer n, Integer x, _true_type) {
+                fill_insert (pos, (size_type)n, (value_type)x);
+             }
+             template <class InputIterator>
+             void insert_dispatch (iterator pos, InputIterator first, InputIterator last, _false_type) {
+                range_insert (pos, first, last, iterator_category (first));
+             }
 
         public:
             //Returns an iterator pointing to the first element in the deque container
@@ -283,7 +498,8 @@ template <class T, class Alloc = SimpleAlloc>
             const_iterator cend () const { return finish; }
             //Returns a reference to the element at position n in the deque container
             reference operator[] (size_type n) {
-                return start[difference_type(n)];
+                size_type index = n + (start.cur - start.first);
+                return start.node[index >> iterator::_BUF_SHIFT][index & iterator::_BUF_MASK];
             }
             //Returns a reference to the first element in the deque container
             reference front () { return *start; }
@@ -306,19 +522,55 @@ template <class T, class Alloc = SimpleAlloc>
             //check if the deque is empty
             bool empty () const { return start == finish; }
             //deque constructor
-            deque (size_type n, const value_type& value)
-                : start(), finish(), map(0), map_size(0) {
+            deque ()
+                : start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
+                    create_map_and_node (0);
+                }
+            explicit deque (const Alloc& a)
+                : data_allocator_type(a), start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
+                    create_map_and_node (0);
+                }
+            deque (size_type n, const value_type& value, const Alloc& a = Alloc())
+                : data_allocator_type(a), start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
                     fill_initiallize (n, value);
                 }
             explicit deque (size_type n) 
-                : start(), finish(), map(0), map_size(0) {
+                : start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
                     fill_initiallize (n, value_type());
                 }
+            //the copy uses the same allocator as x
+            deque (const deque& x)
+                : data_allocator_type(x.get_allocator()), start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
+                    create_map_and_node (x.size());
+                    uninitialed_copy (iterator(x.begin()), iterator(x.end()), start);
+                }
+            //takes over the buffers and the allocator of x, x is left empty
+            deque (deque&& x)
+                : data_allocator_type(x.get_allocator()), start(), finish(), map(0), map_size(0), spare_nodes(), spare_count(0) {
+                    create_map_and_node (0);
+                    swap (x);
+                }
+            //Assigns new contents, the allocator is kept
+            deque& operator= (const deque& x) {
+                if (this != &x) {
+                    clear ();
+                    for (iterator it = x.begin(); it != x.end(); ++it)
+                        push_back (*it);
+                }
+                return *this;
+            }
+            //takes over the contents of x together with its allocator
+            deque& operator= (deque&& x) {
+                deque tmp (std::move(x));
+                swap (tmp);
+                return *this;
+            }
             //Destroys the container object
              ~deque () {
                 clear();
-                data_allocator.deallocate (*start.node);
-                map_allocator.deallocate (map);
+                data_allocator().deallocate (*start.node);
+                release_spare_nodes ();
+                map_allocator().deallocate (map);
              }
             //add a element at the back
             void push_back (const value_type& value) {
@@ -328,19 +580,43 @@ template <class T, class Alloc = SimpleAlloc>
                 } else 
                     push_back_aux (value);
             }
+            void push_back (value_type&& value) {
+                emplace_back (std::move(value));
+            }
+            //add a element constructed in place from args at the back
+            template <class... Args>
+            void emplace_back (Args&&... args) {
+                if (finish.cur != finish.last - 1) {
+                    construct(finish.cur, std::forward<Args>(args)...);
+                    ++finish.cur;
+                } else 
+                    push_back_aux (std::forward<Args>(args)...);
+            }
             //add element at the front
             void push_front (const value_type& value) {
                 if (start.cur != start.first) {
-                    construct (start.cur, value);
+                    construct (start.cur - 1, value);
                     --start.cur;
                 } else 
                     push_front_aux (value);
             }
+            void push_front (value_type&& value) {
+                emplace_front (std::move(value));
+            }
+            //add a element constructed in place from args at the front
+            template <class... Args>
+            void emplace_front (Args&&... args) {
+                if (start.cur != start.first) {
+                    construct (start.cur - 1, std::forward<Args>(args)...);
+                    --start.cur;
+                } else 
+                    push_front_aux (std::forward<Args>(args)...);
+            }
             //remove element at the back
             void pop_back () {
                 if (finish.cur != finish.first) {
-                    destroy (finish.cur);
                     --finish.cur;
+                    destroy (finish.cur);
                 } else 
                     pop_back_aux ();
             }
@@ -356,36 +632,37 @@ template <class T, class Alloc = SimpleAlloc>
             void clear () {
                 for (map_pointer node = start.node + 1; node < finish.node; ++node) {
                     destroy (*node, *node + buf_size());
-                    data_allocator.deallocate (*node);
+                    deallocate_node (*node);
                 }
                 // reserve a buffer
                 if ( start.node != finish.node) {
                     destroy (start.cur, start.last);
                     destroy (finish.first, finish.cur);
-                    data_allocator.deallocate (*finish.node);
+                    deallocate_node (*finish.node);
                 } else {
-                    destroy (start.cur, start.last);
-                    finish = start;
+                    destroy (start.cur, finish.cur);
                 }
-
+                finish = start;
             }
             //erase a single element
             iterator erase (iterator pos) {
                 iterator next = pos;
                 ++next;
                 difference_type index = pos - start;
-                if (index < (size()>>1) ) {
-                    backward_copy (start, pos, next);
+                if (index < (difference_type)(size()>>1) ) {
+                    backward_move (start, pos, pos);
                     pop_front ();
                 } else {
-                    copy (next, finish, pos);
+                    tinySTL::move (next, finish, pos);
                     pop_back();
                 }
                 return start + index;
             }
             //erase several element
             iterator erase (iterator first, iterator last) {
-                if (first == start && last == finish) {
+                if (first == last) {
+                    return first;
+                } else if (first == start && last == finish) {
                     clear();
                     return finish;
                 } else {
@@ -393,23 +670,38 @@ template <class T, class Alloc = SimpleAlloc>
                     difference_type to_finish = finish - last;
                     difference_type to_start = first - start;
                     if (to_start < to_finish) {
-                        backward_copy (start, first, last);
+                        backward_move (start, first, last - 1);
                         iterator new_start = start + n;
                         destroy (start, new_start);
                         for (map_pointer node = start.node; node < new_start.node; ++node)
-                            data_allocator.deallocate (*node);
+                            deallocate_node (*node);
                         start = new_start;
                     } else {
-                        copy (last, finish, first);
+                        tinySTL::move (last, finish, first);
                         iterator new_finish = finish - n;
                         destroy (new_finish, finish);
                         for (map_pointer node = new_finish.node+1; node <= finish.node; ++node) 
-                            data_allocator.deallocate (*node);
+                            deallocate_node (*node);
                         finish = new_finish;
                     }
                     return  start + to_start;
                 }
             }
+            //gives the spare buffers kept for reuse back to the allocator
+            void shrink_to_fit () { release_spare_nodes (); }
+            //Returns a copy of the allocator object associated with the deque
+            Alloc get_allocator () const { return data_allocator_type::get_allocator(); }
+            //Exchanges the content of the container by the content of x, allocators included
+            void swap (deque& x) {
+                data_allocator().swap_allocator (x.data_allocator());
+                tinySTL::swap (start, x.start);
+                tinySTL::swap (finish, x.finish);
+                tinySTL::swap (map, x.map);
+                tinySTL::swap (map_size, x.map_size);
+                for (size_type i = 0; i < _SPARE_NODES; ++i)
+                    tinySTL::swap (spare_nodes[i], x.spare_nodes[i]);
+                tinySTL::swap (spare_count, x.spare_count);
+            }
             //insert element
             iterator insert (iterator pos, const value_type& val) {
                 if (pos == start) {
@@ -417,38 +709,72 @@ template <class T, class Alloc = SimpleAlloc>
                     return start;
                 } else if (pos == finish) {
                     push_back (val);
-                    return finish;
+                    return finish - 1;
                 } else 
                     return insert_aux (pos, val);
             }
+            iterator insert (iterator pos, value_type&& val) {
+                return emplace (pos, std::move(val));
+            }
+            //insert n copies of val before pos, returns the first of them
+            iterator insert (iterator pos, size_type n, const value_type& val) {
+                difference_type index = pos - start;
+                fill_insert (pos, n, val);
+                return start + index;
+            }
+            //insert the elements of [first, last) before pos, returns the first of them
+            template <class InputIterator>
+            iterator insert (iterator pos, InputIterator first, InputIterator last) {
+                typedef typename _bool_type<std::is_integral<InputIterator>::value>::type _integral;
+                difference_type index = pos - start;
+                insert_dispatch (pos, first, last, _integral());
+                return start + index;
+            }
+            //insert a element constructed in place from args before pos
+            template <class... Args>
+            iterator emplace (iterator pos, Args&&... args) {
+                if (pos == start) {
+                    emplace_front (std::forward<Args>(args)...);
+                    return start;
+                } else if (pos == finish) {
+                    emplace_back (std::forward<Args>(args)...);
+                    return finish - 1;
+                } else 
+                    return insert_aux (pos, std::forward<Args>(args)...);
+            }
             
     };
     //Relational operators for deque
-    template <class T>
-        inline bool operator== (const deque<T>& lhs, const deque<T>& rhs) {
-            return lhs.size() == rhs.size() && equal (lhs.begin(), lhs.end(), rhs.begin());
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator== (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
+            return lhs.size() == rhs.size() && tinySTL::equal (lhs.begin(), lhs.end(), rhs.begin());
         }
-    template <class T>
-        inline bool operator!= (const deque<T>& lhs, const deque<T>& rhs) {
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator!= (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
             return !(lhs == rhs);
         }
-    template <class T>
-        inline bool operator< (const deque<T>& lhs, const deque<T>& rhs) {
-            return lexicographical_compare (lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator< (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
+            return tinySTL::lexicographical_compare (lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
         }
-    template <class T>
-        inline bool operator<= (const deque<T>& lhs, const deque<T>& rhs) {
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator<= (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
             return lhs == rhs || lhs < rhs;
         }
 
-    template <class T>
-        inline bool operator> (const deque<T>& lhs, const deque<T>& rhs) {
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator> (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
             return !(lhs <= rhs);
         }
-    template <class T>
-        inline bool operator>= (const deque<T>& lhs, const deque<T>& rhs) {
+    template <class T, class Alloc, size_t BufBytes>
+        inline bool operator>= (const deque<T, Alloc, BufBytes>& lhs, const deque<T, Alloc, BufBytes>& rhs) {
             return lhs == rhs || lhs > rhs;
         }
+    //Exchanges the contents of two deques
+    template <class T, class Alloc, size_t BufBytes>
+        inline void swap (deque<T, Alloc, BufBytes>& x, deque<T, Alloc, BufBytes>& y) {
+            x.swap(y);
+        }
 }
 
 #endif
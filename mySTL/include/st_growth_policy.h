@@ -0,0 +1,50 @@
+#ifndef ST_GROWTH_POLICY_H
+#define ST_GROWTH_POLICY_H
+#include <stddef.h>
+
+//Growth policies of vector. grow(capacity, needed, elem_size) returns the
+//new capacity in elements when a vector of the given capacity must hold
+//needed > capacity elements of elem_size bytes.
+
+namespace tinySTL {
+    //doubling, the fewest reallocations
+    struct grow_double {
+        static size_t grow (size_t capacity, size_t needed, size_t) {
+            return capacity * 2 > needed ? capacity * 2 : needed;
+        }
+    };
+
+    //1.5x: the blocks freed by earlier steps add up to more than the next
+    //request after a few steps, so a free-list allocator can reuse them
+    struct grow_one_and_half {
+        static size_t grow (size_t capacity, size_t needed, size_t) {
+            size_t next = capacity + capacity / 2;
+            return next > needed ? next : needed;
+        }
+    };
+
+    //1.5x rounded up to the block the allocator hands out anyway: 16 byte
+    //steps for small blocks, quarter steps of each power of two up to a
+    //page, whole pages above it. The rounding is spare capacity for free.
+    struct grow_page_aware {
+        enum {_PAGE = 4096, _SMALL = 128, _STEPS = 4};
+
+        static size_t round_bytes (size_t bytes) {
+            if (bytes <= _SMALL)
+                return (bytes + 15) & ~(size_t)15;
+            if (bytes >= _PAGE)
+                return (bytes + _PAGE - 1) & ~(size_t)(_PAGE - 1);
+            size_t base = _SMALL;
+            while (base * 2 < bytes)
+                base *= 2;
+            size_t step = base / _STEPS;
+            return (bytes + step - 1) / step * step;
+        }
+
+        static size_t grow (size_t capacity, size_t needed, size_t elem_size) {
+            size_t next = grow_one_and_half::grow (capacity, needed, elem_size);
+            return round_bytes (next * elem_size) / elem_size;
+        }
+    };
+}
+#endif // ST_GROWTH_POLICY_H
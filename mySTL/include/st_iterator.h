@@ -1,12 +1,16 @@
 #ifndef ST_ITERATOR_H
 #define ST_ITERATOR_H
 #include <stddef.h>
+#include "st_typetrait.h"
 namespace tinySTL {
     struct input_iterator_tag {};
     struct output_iterator_tag {};
     struct forward_iterator_tag : public input_iterator_tag { };
     struct bidirectional_iterator_tag : public forward_iterator_tag { };
     struct random_access_iterator_tag : public bidirectional_iterator_tag { };
+    //random access over elements laid out one after another in memory,
+    //so a range can be handled as a pointer range
+    struct contiguous_iterator_tag : public random_access_iterator_tag { };
 
     template <class T, class Distance>
     struct input_iterator {
@@ -76,7 +80,7 @@ namespace tinySTL {
 
     template <class T>
     struct iterator_traits<T*> {
-        typedef random_access_iterator_tag  iterator_category;
+        typedef contiguous_iterator_tag     iterator_category;
         typedef T                           value_type;
         typedef T*                          pointer;
         typedef T&                          reference;
@@ -86,13 +90,22 @@ namespace tinySTL {
 
     template <class T>
     struct iterator_traits<const T*> {
-        typedef random_access_iterator_tag  iterator_category;
+        typedef contiguous_iterator_tag     iterator_category;
         typedef T                           value_type;
         typedef const T*                    pointer;
         typedef const T&                    reference;
         typedef ptrdiff_t                   difference_type;
     };
 
+    //an iterator over a sequence of contiguous segments, such as the
+    //buffers of a deque, specializes this to expose them: segment(it) is
+    //the segment it is in, local(it) the pointer inside it, and begin(seg),
+    //end(seg) the pointer range of a whole segment
+    template <class Iterator>
+    struct segmented_iterator_traits {
+        typedef _false_type     is_segmented_iterator;
+    };
+
     template <class Iterator>
     inline typename iterator_traits<Iterator>::iterator_category
         iterator_category(const Iterator& ) {
@@ -3,6 +3,7 @@
 
 #include "st_iterator.h"
 #include "st_allocator.h"
+#include "st_node_pool.h"
 #include "st_algorithm.h"
 #include "st_construct.h"
 #include <assert.h>
@@ -17,6 +18,16 @@ template <class T>
         T   data;
     };
 
+    //default-allocated lists take their nodes from a node_pool
+template <class T>
+    class simple_alloc<_list_node<T>, SimpleAlloc> : public pool_node_alloc<_list_node<T> > {
+        public:
+            simple_alloc () { }
+            simple_alloc (const SimpleAlloc&) { }
+            template <class U>
+            simple_alloc (const simple_alloc<U, SimpleAlloc>&) { }
+    };
+
 template <class T, class Ref, class Ptr>
     class list_iterator {
         public:
@@ -66,9 +77,10 @@ template <class T, class Ref, class Ptr>
 };
 
 template <class T, class Alloc = SimpleAlloc >
-class list {
+class list : private simple_alloc<_list_node<T>, Alloc> {
 protected:
     typedef _list_node<T>   list_node;
+    typedef simple_alloc<_list_node<T>, Alloc>  node_allocator_type;
     
 public:
     typedef list_node*      link_type;
@@ -83,19 +95,19 @@ protected:
     link_type   node;
 
 private:
-    simple_alloc<_list_node<T> , Alloc> node_allocator;
-
-private:
+    //the allocator lives in the base, empty allocators take no space
+    node_allocator_type& node_allocator() { return *this; }
     //allocate a single node
-    link_type get_node () { return node_allocator.allocate(1); }
+    link_type get_node () { return node_allocator().allocate(1); }
     //deallocate a node
     void put_node(link_type ptr) {
-        node_allocator.deallocate(ptr);
+        node_allocator().deallocate(ptr);
     }
-    //construct a node and return the link_type position
-    link_type create_node(const T& data) {
+    //construct a node from args and return the link_type position
+    template <class... Args>
+    link_type create_node(Args&&... args) {
         link_type p = get_node();
-        construct(&(p->data), data);
+        construct(&(p->data), std::forward<Args>(args)...);
         return p;
     }
     //destroy a node
@@ -109,11 +121,12 @@ private:
         node->next = node;
         node->prev = node;
     }
-    //insert base function
-    iterator insert_aux (const_iterator position, const value_type& val) {
+    //insert base function, the new element is constructed from args
+    template <class... Args>
+    iterator insert_aux (const_iterator position, Args&&... args) {
         iterator cur = position;
         link_type prev = (link_type) cur.node->prev;
-        link_type result = create_node(val);
+        link_type result = create_node(std::forward<Args>(args)...);
         prev->next = result;
         result->prev = prev;
         result->next = cur.node;
@@ -143,11 +156,11 @@ public:
     const_iterator end() const { return node; }
     const_iterator cend() const {return node; }
     //Returns a reference to the last element in the list container
-    reference back() { return &(node->prev->data); }
-    const_reference back() const { return &(node->prev->data); }
+    reference back() { return ((link_type) node->prev)->data; }
+    const_reference back() const { return ((link_type) node->prev)->data; }
     //Returns a reference to the first element in the list container.
-    reference front() { return &(node->next->data); }
-    const_reference front() const { return &(node->next->data); }
+    reference front() { return ((link_type) node->next)->data; }
+    const_reference front() const { return ((link_type) node->next)->data; }
     //Return reverse iterator to reverse beginning
     iterator rbegin() { return  (link_type) (*node).prev; }
     const_iterator rbegin() const { return (link_type) (*node).prev; }
@@ -162,17 +175,22 @@ public:
     size_type size() const { return distance(begin(), end()); }
     //Constructs a list container object, initializing its contents depending on the constructor version used
     list() { empty_initialize(); }
-    list (iterator first, iterator last) {
-        link_type cur = node;
-        for(; first != last; ++first, ++cur) {
-            link_type result = create_node(first.node->data);
-            result->next = cur->next;
-            cur->next = result;
-        }
+    explicit list (const Alloc& a) : node_allocator_type(a) { empty_initialize(); }
+    list (iterator first, iterator last, const Alloc& a = Alloc()) : node_allocator_type(a) {
+        empty_initialize();
+        for(; first != last; ++first)
+            push_back(*first);
+    }
+    //Constructs a list container object, the copy uses the same allocator as x
+    list (const list& x) : node_allocator_type(x.get_allocator()) {
+        empty_initialize();
+        for(iterator it = x.begin(); it != x.end(); ++it)
+            push_back(*it);
     }
-    //Constructs a list container object
-    list (const list& x) {
-        list(x.begin(), x.end());
+    //takes over the nodes and the allocator of x, which is left empty
+    list (list&& x) : node_allocator_type(x.get_allocator()) {
+        empty_initialize();
+        tinySTL::swap(node, x.node);
     }
     //Destroys the container object.
     ~list() {
@@ -181,7 +199,14 @@ public:
     }
     //Assigns new contents to the container, replacing its current contents
     list& operator= (const list& x) {
-        node = x.node;
+        if (this != &x)
+            assign (x.begin(), x.end());
+        return *this;
+    }
+    //takes over the contents of x together with its allocator
+    list& operator= (list&& x) {
+        list tmp(std::move(x));
+        swap(tmp);
         return *this;
     }
 
@@ -189,6 +214,14 @@ public:
     iterator insert (const_iterator position, const value_type& val) {
         return insert_aux (position, val);
     }
+    iterator insert (const_iterator position, value_type&& val) {
+        return insert_aux (position, std::move(val));
+    }
+    //inserts an element constructed in place from args before position
+    template <class... Args>
+    iterator emplace (const_iterator position, Args&&... args) {
+        return insert_aux (position, std::forward<Args>(args)...);
+    }
     //The container is extended by inserting new elements before the element at the specified position
     iterator insert (const_iterator position, size_type n, const value_type& val) {
        iterator cur = position;
@@ -201,21 +234,37 @@ public:
     //The container is extended by inserting new elements before the element at the specified position
     template <class InputIterator>
     iterator insert (const_iterator position, InputIterator first, InputIterator last) {
-        iterator cur = position;
-        iterator start = cur;
-        for (; first != last; ++first, ++cur) {
-            insert_aux (cur, first->data);
+        iterator result = position;
+        for (; first != last; ++first) {
+            iterator cur = insert_aux (position, *first);
+            if (result == position) result = cur;
         }
-        return start;
+        return result;
     }
     //Adds a new element at the end of the list container,
     void push_back (const value_type& val) {
         insert_aux (node, val);
     }
+    void push_back (value_type&& val) {
+        insert_aux (node, std::move(val));
+    }
+    //Adds an element constructed in place from args at the end
+    template <class... Args>
+    void emplace_back (Args&&... args) {
+        insert_aux (node, std::forward<Args>(args)...);
+    }
     //Inserts a new element at the beginning of the list
     void push_front (const value_type& val) {
         insert_aux ((link_type)node->next, val);
     }
+    void push_front (value_type&& val) {
+        insert_aux ((link_type)node->next, std::move(val));
+    }
+    //Inserts an element constructed in place from args at the beginning
+    template <class... Args>
+    void emplace_front (Args&&... args) {
+        insert_aux ((link_type)node->next, std::forward<Args>(args)...);
+    }
     //Removes the last element in the list container, effectively reducing the container size by one
     void pop_back () {
         if (node->next != node)
@@ -254,33 +303,31 @@ public:
     }
     //Removes from the list container either a single element (position) or a range of elements
     iterator erase (const_iterator position) {
-       if(position != node) {
-         link_type cur = (link_type) position.node->prev; 
-         link_type result = (link_type) position.node->next;
-         cur->next = result;
-         result->prev = cur;
-         destroy_node(position.node);
-         return result;
-       }
+       if(position == node)
+         return node;
+       link_type cur = (link_type) position.node->prev; 
+       link_type result = (link_type) position.node->next;
+       cur->next = result;
+       result->prev = cur;
+       destroy_node(position.node);
+       return result;
     }
     //Removes from the list container either a single element (position) or a range of elements ([first,last)).
     iterator erase (const_iterator first, const_iterator last ) {
-        if (last != (link_type)node->next) {
-            link_type cur = (link_type)first.node->prev;
-            link_type result = (link_type) last.node;
-            cur->next = result;
-            result->prev = cur;
-            link_type ptr = (link_type) first.node;
-            while (ptr != last.node) { 
-                link_type tmp = (link_type)ptr->next;
-                destroy_node(ptr);
-                ptr = tmp;
-            }
-            return result;
+        link_type cur = (link_type)first.node->prev;
+        link_type result = (link_type) last.node;
+        cur->next = result;
+        result->prev = cur;
+        link_type ptr = (link_type) first.node;
+        while (ptr != last.node) { 
+            link_type tmp = (link_type)ptr->next;
+            destroy_node(ptr);
+            ptr = tmp;
         }
+        return result;
     }
     //Returns a copy of the allocator object associated with the list container
-    Alloc get_allocator () const { return node_allocator; }
+    Alloc get_allocator () const { return node_allocator_type::get_allocator(); }
     //Removes all elements from the list container  
     void clear () { erase(begin(), end()); }
     //Returns the maximum number of elements that the list container can hold.
@@ -414,8 +461,9 @@ public:
             xcur = _next;
         }
     }
-    //Constants complexity
+    //Constants complexity, allocators are exchanged too
     void swap (list& x) {
+        node_allocator().swap_allocator(x.node_allocator());
         link_type tmp = node;
         node = x.node;
         x.node = tmp;
@@ -442,35 +490,75 @@ public:
     void sort() {
         sort(tinySTL::less<T>());
     }
-    //merge sort
+    //bottom-up merge sort on the node chain, no helper list is constructed
+    //so it needs nothing from the allocator
     template <class Compare>
         void sort (Compare comp) {
             if (node->next == node || ((link_type)node->next)->next == node)
                 return ;
-            list<T> carry;
-            list<T> counter[64];
+            ((link_type) node->prev)->next = 0;
+            link_type rest = (link_type) node->next;
+            link_type counter[64];
             int fill = 0;
-            while (!empty()) {
+            while (rest != 0) {
+                link_type carry = rest;
+                rest = (link_type) rest->next;
+                carry->next = 0;
                 int i = 0;
-                carry.splice(carry.begin(), *this, begin());
-                while (i<fill && !counter[i].empty()) {
-                    counter[i].merge(carry, comp);
-                    carry.swap(counter[i++]);
+                while (i < fill && counter[i] != 0) {
+                    carry = merge_chain (counter[i], carry, comp);
+                    counter[i++] = 0;
                 }
-                carry.swap(counter[i]);
-                if (i==fill) ++fill;
+                counter[i] = carry;
+                if (i == fill) ++fill;
             }
+            link_type result = 0;
+            for (int i = 0; i < fill; ++i)
+                if (counter[i] != 0)
+                    result = result == 0 ? counter[i] : merge_chain (counter[i], result, comp);
 
-            for (int i=1; i<fill; ++i) 
-                counter[i].merge(counter[i-1], comp);
-            swap(counter[fill-1]);
+            link_type prev = node;
+            for (link_type cur = result; cur != 0; cur = (link_type) cur->next) {
+                prev->next = cur;
+                cur->prev = prev;
+                prev = cur;
+            }
+            prev->next = node;
+            node->prev = prev;
+        }
+private:
+    //merge two null terminated chains linked by next, a holds the earlier elements
+    template <class Compare>
+        static link_type merge_chain (link_type a, link_type b, Compare comp) {
+            link_type head;
+            if (comp (b->data, a->data)) {
+                head = b;
+                b = (link_type) b->next;
+            } else {
+                head = a;
+                a = (link_type) a->next;
+            }
+            link_type last = head;
+            while (a != 0 && b != 0) {
+                if (comp (b->data, a->data)) {
+                    last->next = b;
+                    last = b;
+                    b = (link_type) b->next;
+                } else {
+                    last->next = a;
+                    last = a;
+                    a = (link_type) a->next;
+                }
+            }
+            last->next = a != 0 ? a : b;
+            return head;
         }
 };
     //Performs the appropriate comparison operation between the list containers lhs and rhs.
-    template <class T>
-        inline bool operator== (const list<T>& lhs, const list<T>& rhs) {
-            typename list<T>::iterator first1 = lhs.begin();
-            typename list<T>::iterator first2 = rhs.begin();
+    template <class T, class Alloc>
+        inline bool operator== (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
+            typename list<T, Alloc>::iterator first1 = lhs.begin();
+            typename list<T, Alloc>::iterator first2 = rhs.begin();
             while (first1 != lhs.end()) {
                 if ( first2 == rhs.end() ) return false;
                 if ( *first1 != *first2 ) return false;
@@ -478,30 +566,30 @@ public:
             }
             return (first2 == rhs.end());
         }
-    template <class T>
-        inline bool operator!= (const list<T>& lhs, const list<T>& rhs) {
+    template <class T, class Alloc>
+        inline bool operator!= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
             return !(lhs == rhs);
         }
     
-    template <class T>
-        inline bool operator< (const list<T>& lhs, const list<T>& rhs) {
+    template <class T, class Alloc>
+        inline bool operator< (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
             return lexicographical_compare (lhs.begin(), lhs.end(), rhs.begin(), rhs.end() );
         }
-    template <class T>
-        inline bool operator<= (const list<T>& lhs, const list<T>& rhs) {
+    template <class T, class Alloc>
+        inline bool operator<= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
             return (lhs < rhs || lhs == rhs);
         }
-    template <class T> 
-        inline bool operator> (const list<T>& lhs, const list<T>& rhs) {
+    template <class T, class Alloc> 
+        inline bool operator> (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
             return lexicographical_compare (rhs.begin(), rhs.end(), lhs.begin(), lhs.end() );
         }
-    template <class T>
-        inline bool operator>= (const list<T>& lhs, const list<T>& rhs) {
+    template <class T, class Alloc>
+        inline bool operator>= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs) {
             return (lhs >rhs || lhs == rhs);
         }
     //Exchanges the contents of two lists
-    template <class T>
-        void swap (list<T>& x, list<T>& y) {
+    template <class T, class Alloc>
+        void swap (list<T, Alloc>& x, list<T, Alloc>& y) {
             x.swap(y);
         }
 }
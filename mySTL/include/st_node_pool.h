@@ -0,0 +1,357 @@
+#ifndef ST_NODE_POOL_H
+#define ST_NODE_POOL_H
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <mutex>
+#include <atomic>
+#include "st_allocator.h"
+#include "st_chunk_provider.h"
+
+namespace tinySTL {
+    //provider of the regions all node pools cut their slabs from
+    inline std::atomic<const chunk_provider*>& node_pool_provider() {
+        static std::atomic<const chunk_provider*> provider(&malloc_chunks());
+        return provider;
+    }
+
+    //take later regions from p, return the provider used so far
+    inline const chunk_provider& set_node_pool_chunk_provider(const chunk_provider& p) {
+        return *node_pool_provider().exchange(&p);
+    }
+
+    //Free-list pool for objects of one size and alignment. Objects are
+    //carved from page-sized slabs and threaded on an intrusive free list;
+    //slabs are cut from regions of the node_pool_provider.
+    //Each thread caches up to two batches of free objects. A free that
+    //fills the cache hands one batch to a shared depot, an empty cache
+    //takes one batch from it, so objects freed by a consumer thread flow
+    //back to the producer. When the depot has grown large the regions
+    //without live objects go back to the provider; trim() does it at once.
+template <size_t Size, size_t Align>
+    class node_pool {
+    private:
+        struct obj {
+            obj*    next;
+        };
+        enum {_SLAB_BYTES = 4096, _MIN_OBJS = 8, _REGION_BYTES = 64 * 1024};
+        enum {_STRIDE = ((Size > sizeof(obj) ? Size : sizeof(obj)) + Align - 1) / Align * Align};
+        enum {_SLAB_OBJS = _SLAB_BYTES / _STRIDE > _MIN_OBJS ? _SLAB_BYTES / _STRIDE : _MIN_OBJS};
+        enum {_SLAB = _SLAB_OBJS * _STRIDE};
+        //objects moved between a thread cache and the depot at a time,
+        //a thread parks at most about 64K of free objects
+        enum {_BATCH_BYTES = 32768};
+        enum {_BATCH = _BATCH_BYTES / _STRIDE > _SLAB_OBJS ? _BATCH_BYTES / _STRIDE : _SLAB_OBJS};
+        //the depot is not trimmed below this many objects
+        enum {_TRIM_OBJS = 16 * (_REGION_BYTES / _STRIDE)};
+
+        //per-thread cache, no lock needed
+        struct cache {
+            obj*    head;
+            size_t  count;
+        };
+        //gives the thread cache to the depot when the thread exits
+        struct cache_reaper {
+            bool armed;
+            cache_reaper() : armed(false) {}
+            ~cache_reaper();
+        };
+        //every region obtained from a provider, sorted by address
+        struct region_info {
+            char*   begin;
+            size_t  bytes;
+            size_t  carved;     //objects cut out of this region so far
+            const chunk_provider* source;
+        };
+
+        static thread_local cache           local;
+        static thread_local cache_reaper    reaper;
+        //the depot, guarded by depot_lock
+        static std::mutex   depot_lock;
+        static obj*         depot;
+        static size_t       depot_count;
+        static size_t       trim_at;
+        static region_info* regions;
+        static size_t       nregions;
+        static size_t       regions_cap;
+        static size_t       region_bytes;
+        static char*        region_cur;
+        static char*        region_end;
+
+        static void refill();
+        static void spill(size_t count);
+        static void carve();
+        static void register_region(char* begin, size_t bytes, const chunk_provider* source);
+        static region_info* find_region(void* p);
+        static size_t trim_locked();
+
+    public:
+        static void* allocate() {
+            obj* result = local.head;
+            if (!result) {
+                refill();
+                result = local.head;
+            }
+            local.head = result->next;
+            --local.count;
+            return result;
+        }
+
+        static void deallocate(void* p) {
+            obj* o = (obj*)p;
+            o->next = local.head;
+            local.head = o;
+            if (++local.count == 1)
+                reaper.armed = true;
+            else if (local.count >= 2 * _BATCH)
+                spill(_BATCH);
+        }
+
+        //bytes currently held from the providers
+        static size_t heap_size() {
+            std::lock_guard<std::mutex> guard(depot_lock);
+            return region_bytes;
+        }
+        //give the calling thread's cache to the depot and return the
+        //regions without live objects, returns the bytes released.
+        //Objects cached by other threads count as live.
+        static size_t trim() {
+            spill(local.count);
+            std::lock_guard<std::mutex> guard(depot_lock);
+            return trim_locked();
+        }
+    };
+
+template <size_t Size, size_t Align>
+    thread_local typename node_pool<Size, Align>::cache node_pool<Size, Align>::local = {0, 0};
+template <size_t Size, size_t Align>
+    thread_local typename node_pool<Size, Align>::cache_reaper node_pool<Size, Align>::reaper;
+template <size_t Size, size_t Align>
+    std::mutex node_pool<Size, Align>::depot_lock;
+template <size_t Size, size_t Align>
+    typename node_pool<Size, Align>::obj* node_pool<Size, Align>::depot = 0;
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::depot_count = 0;
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::trim_at = _TRIM_OBJS;
+template <size_t Size, size_t Align>
+    typename node_pool<Size, Align>::region_info* node_pool<Size, Align>::regions = 0;
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::nregions = 0;
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::regions_cap = 0;
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::region_bytes = 0;
+template <size_t Size, size_t Align>
+    char* node_pool<Size, Align>::region_cur = 0;
+template <size_t Size, size_t Align>
+    char* node_pool<Size, Align>::region_end = 0;
+
+    //move one batch from the depot into the empty cache, or carve a new slab
+template <size_t Size, size_t Align>
+    void node_pool<Size, Align>::refill() {
+        reaper.armed = true;
+        std::lock_guard<std::mutex> guard(depot_lock);
+        if (!depot)
+            carve();
+        obj* tail = depot;
+        size_t count = 1;
+        while (count < _BATCH && tail->next) {
+            tail = tail->next;
+            ++count;
+        }
+        local.head = depot;
+        local.count = count;
+        depot = tail->next;
+        depot_count -= count;
+        tail->next = 0;
+    }
+
+    //hand the first count objects of the cache to the depot, trimming it
+    //when it has doubled since the last trim
+template <size_t Size, size_t Align>
+    void node_pool<Size, Align>::spill(size_t count) {
+        if (count == 0) return;
+        obj* head = local.head;
+        obj* tail = head;
+        for (size_t i = 1; i < count; ++i)
+            tail = tail->next;
+        local.head = tail->next;
+        local.count -= count;
+
+        std::lock_guard<std::mutex> guard(depot_lock);
+        tail->next = depot;
+        depot = head;
+        depot_count += count;
+        if (depot_count >= trim_at) {
+            trim_locked();
+            trim_at = 2 * depot_count > (size_t)_TRIM_OBJS ? 2 * depot_count : (size_t)_TRIM_OBJS;
+        }
+    }
+
+    //called with depot_lock held: put a new slab on the depot, cut from
+    //the current region or from a new one
+template <size_t Size, size_t Align>
+    void node_pool<Size, Align>::carve() {
+        if ((size_t)(region_end - region_cur) < _SLAB) {
+            const chunk_provider& source = *node_pool_provider().load();
+            //room to align the first slab
+            size_t bytes = _SLAB + Align > _REGION_BYTES ? _SLAB + Align : (size_t)_REGION_BYTES;
+            bytes = round_to_granularity (source, bytes);
+            char* region = (char*)source.acquire (bytes);
+            if (!region) {
+                std::cerr<<"out of memory!"<<std::endl;
+                exit(1);
+            }
+            register_region (region, bytes, &source);
+            region_cur = (char*)(((size_t)region + Align - 1) & ~(size_t)(Align - 1));
+            region_end = region + bytes;
+        }
+
+        char* slab = region_cur;
+        region_cur += _SLAB;
+        find_region (slab)->carved += _SLAB_OBJS;
+        char* cur = slab;
+        char* last = slab + (_SLAB_OBJS - 1) * _STRIDE;
+        for (; cur < last; cur += _STRIDE)
+            ((obj*)cur)->next = (obj*)(cur + _STRIDE);
+        ((obj*)cur)->next = depot;
+        depot = (obj*)slab;
+        depot_count += _SLAB_OBJS;
+    }
+
+    //called with depot_lock held
+template <size_t Size, size_t Align>
+    void node_pool<Size, Align>::register_region(char* begin, size_t bytes, const chunk_provider* source) {
+        if (nregions == regions_cap) {
+            size_t new_cap = regions_cap == 0 ? 16 : 2 * regions_cap;
+            region_info* tmp = (region_info*)realloc(regions, new_cap * sizeof(region_info));
+            if (!tmp) {
+                std::cerr<<"out of memory!"<<std::endl;
+                exit(1);
+            }
+            regions = tmp;
+            regions_cap = new_cap;
+        }
+        size_t pos = nregions;
+        while (pos > 0 && regions[pos - 1].begin > begin)
+            --pos;
+        memmove(regions + pos + 1, regions + pos, (nregions - pos) * sizeof(region_info));
+        regions[pos].begin = begin;
+        regions[pos].bytes = bytes;
+        regions[pos].carved = 0;
+        regions[pos].source = source;
+        ++nregions;
+        region_bytes += bytes;
+    }
+
+    //called with depot_lock held
+template <size_t Size, size_t Align>
+    typename node_pool<Size, Align>::region_info* node_pool<Size, Align>::find_region(void* ptr) {
+        char* p = (char*)ptr;
+        size_t lo = 0, hi = nregions;
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (p < regions[mid].begin)
+                hi = mid;
+            else if (p >= regions[mid].begin + regions[mid].bytes)
+                lo = mid + 1;
+            else
+                return regions + mid;
+        }
+        return 0;
+    }
+
+    //called with depot_lock held: release the regions all of whose
+    //carved objects are on the depot
+template <size_t Size, size_t Align>
+    size_t node_pool<Size, Align>::trim_locked() {
+        size_t* free_objs = (size_t*)calloc(nregions + 1, sizeof(size_t));
+        if (!free_objs) return 0;
+        for (obj* p = depot; p; p = p->next)
+            ++free_objs[find_region(p) - regions];
+
+        //mark the regions without live objects
+        const size_t unused = (size_t)-1;
+        size_t released = 0;
+        for (size_t i = 0; i < nregions; ++i) {
+            if (regions[i].carved != 0 && free_objs[i] == regions[i].carved) {
+                released += regions[i].bytes;
+                free_objs[i] = unused;
+            }
+        }
+        if (released == 0) {
+            free(free_objs);
+            return 0;
+        }
+
+        //unlink the free objects living in released regions
+        obj** link = &depot;
+        while (*link) {
+            if (free_objs[find_region(*link) - regions] == unused) {
+                *link = (*link)->next;
+                --depot_count;
+            } else
+                link = &(*link)->next;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < nregions; ++i) {
+            if (free_objs[i] == unused) {
+                if (region_cur >= regions[i].begin && region_cur < regions[i].begin + regions[i].bytes)
+                    region_cur = region_end = 0;
+                regions[i].source->release(regions[i].begin, regions[i].bytes);
+            } else {
+                regions[kept++] = regions[i];
+            }
+        }
+        nregions = kept;
+        region_bytes -= released;
+        free(free_objs);
+        return released;
+    }
+
+template <size_t Size, size_t Align>
+    node_pool<Size, Align>::cache_reaper::~cache_reaper() {
+        if (armed)
+            spill(local.count);
+    }
+
+    //Allocator for node containers using the default SimpleAlloc: single
+    //nodes come from the node_pool of their size. list and rb_tree only
+    //ever allocate one node at a time.
+template <class Node>
+    class pool_node_alloc {
+    private:
+        typedef node_pool<sizeof(Node), alignof(Node)>   pool;
+
+    public:
+        typedef SimpleAlloc     allocator_type;
+
+        SimpleAlloc get_allocator () const { return SimpleAlloc(); }
+
+        Node* allocate (size_t n) {
+            assert (n == 1);
+            return allocate ();
+        }
+
+        Node* allocate () {
+            Node* result = (Node*) pool::allocate();
+#ifdef ST_ALLOC_TRACE
+            alloc_trace_recorder::instance().record_alloc (result, sizeof (Node));
+#endif
+            return result;
+        }
+
+        void deallocate (Node* p) {
+#ifdef ST_ALLOC_TRACE
+            alloc_trace_recorder::instance().record_free (p);
+#endif
+            pool::deallocate (p);
+        }
+
+        void swap_allocator (pool_node_alloc&) { }
+    };
+}
+#endif // ST_NODE_POOL_H
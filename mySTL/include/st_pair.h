@@ -7,14 +7,10 @@ template <class T1, class T2>
         public :
             typedef T1  first_type;
             typedef T2  second_type;
-        private:
             first_type first;
             second_type second;
-        public:
-            pair (const T1& a, const T2& b) {
-                first = a;
-                second = b;
-            }
+
+            pair (const T1& a, const T2& b) : first(a), second(b) { }
             ~pair () { }
     };
 }
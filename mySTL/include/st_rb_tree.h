@@ -1,8 +1,10 @@
 #ifndef ST_RB_TREE
 #define ST_RB_TREE
 #include "st_allocator.h"
+#include "st_node_pool.h"
 #include "st_construct.h"
 #include "st_pair.h"
+#include "st_algorithm.h"
 
 namespace tinySTL {
 
@@ -41,6 +43,16 @@ public:
     value_type  value_field;
 };
 
+//default-allocated trees take their nodes from a node_pool
+template <class T>
+class simple_alloc<_rb_tree_node<T>, SimpleAlloc> : public pool_node_alloc<_rb_tree_node<T> > {
+    public:
+        simple_alloc () { }
+        simple_alloc (const SimpleAlloc&) { }
+        template <class U>
+        simple_alloc (const simple_alloc<U, SimpleAlloc>&) { }
+};
+
 struct  _rb_tree_base_iterator {
     typedef rb_tree_base::base_ptr base_ptr;
     typedef bidirectional_iterator_tag  iterator_category;
@@ -49,6 +61,9 @@ struct  _rb_tree_base_iterator {
 
     base_ptr   node;
 
+    bool operator== (const _rb_tree_base_iterator& x) const { return node == x.node; }
+    bool operator!= (const _rb_tree_base_iterator& x) const { return node != x.node; }
+
     void increment () {
         if (node->right != 0) {
             node = node->right;
@@ -66,7 +81,7 @@ struct  _rb_tree_base_iterator {
     }
 
     void decrement () {
-        if (node->color == _red && node->parent == node->parent->parent) 
+        if (node->color == _red && node->parent->parent == node)
             node = node->right;
         else if ( node->left != 0) {
             node = node->left;
@@ -89,7 +104,7 @@ template <class T>
         typedef T*                                          pointer;
         typedef rb_tree_iterator<T>                         iterator;
         typedef const rb_tree_iterator<T>                   const_iterator;
-        typedef rb_tree_iterator<T>*                        link_type;
+        typedef _rb_tree_node<T>*                           link_type;
         typedef typename _rb_tree_base_iterator::base_ptr   base_ptr;
 
         rb_tree_iterator() {}
@@ -124,7 +139,7 @@ template <class T>
     };
 
 template <class Key, class Value, class KeyofValue, class Compare, class Alloc = SimpleAlloc >
-class rb_tree {
+class rb_tree : private simple_alloc<_rb_tree_node<Value>, Alloc> {
     public:
         typedef _rb_tree_node<Value>                        rb_tree_node;
         typedef simple_alloc<rb_tree_node, Alloc>           rb_tree_node_allocator;
@@ -142,13 +157,15 @@ class rb_tree {
         typedef ptrdiff_t                                   difference_type;
 
     protected:
-        
-        link_type get_node () { return rb_tree_node_allocator::allocate(1); }
-        link_type put_node (link_type p) { rb_tree_node_allocator::deallocate(p); }
+        //the allocator lives in the base, empty allocators take no space
+        rb_tree_node_allocator& node_allocator () { return *this; }
+        link_type get_node () { return node_allocator().allocate(1); }
+        void put_node (link_type p) { node_allocator().deallocate(p); }
 
-        link_type create_node (const value_type& val) {
+        template <class... Args>
+        link_type create_node (Args&&... args) {
             link_type tmp = get_node();
-            construct (&tmp->value_field, val);
+            construct (&tmp->value_field, std::forward<Args>(args)...);
             return tmp;
         }
 
@@ -187,7 +204,8 @@ class rb_tree {
         static link_type& parent (link_type x) { return (link_type&) x->parent; }
 
         static reference value (link_type x) { return x->value_field; }
-        static const Key key (link_type X) { return KeyofValue() (value(X)); }
+        //whatever KeyofValue returns, a reference only when it returns one
+        static auto key (link_type X) -> decltype (KeyofValue() (value(X))) { return KeyofValue() (value(X)); }
         static color_type& color (link_type x) { return (color_type&) x->color; }
 
         static link_type minimum (link_type x) {
@@ -202,11 +220,9 @@ class rb_tree {
         typedef rb_tree_iterator<value_type> iterator;
     
     private:
-        //x is the insert pos, x != 0 for equal case
-        iterator _insert (link_type x, link_type y, const value_type& val) {
-            link_type z;
-            if (y == header || x != 0 || key_compare (KeyofValue()(val), key(y))) {
-                z = create_node (val);
+        //hang the new node z under y, x != 0 for equal case
+        iterator _link (link_type x, link_type y, link_type z) {
+            if (y == header || x != 0 || key_compare (key(z), key(y))) {
                 left(y) = z;
                 if ( y == header) {
                     root() = z;
@@ -215,7 +231,6 @@ class rb_tree {
                 else if (y == leftmost())
                     leftmost() = z;
             } else {
-                z = create_node(val);
                 right(y) = z;
                 if (y == rightmost () )
                     rightmost() = z;
@@ -229,8 +244,88 @@ class rb_tree {
             return iterator (z);
         }
 
+        //x is the insert pos, the node is built from args
+        template <class... Args>
+        iterator _insert (link_type x, link_type y, Args&&... args) {
+            return _link (x, y, create_node (std::forward<Args>(args)...));
+        }
+
+        //find the parent pre for a unique key k, false if k is there already,
+        //j is then the element holding it
+        bool _get_insert_unique_pos (const Key& k, link_type& cur, link_type& pre, iterator& j) {
+            pre = header;
+            cur = root();
+            bool comp = true;
+            while (cur != 0) {
+                pre = cur;
+                comp = key_compare(k, key(cur));
+                cur = comp ? left (cur) : right (cur);
+            }
+            j = iterator (pre);
+            if (comp) {
+                if (j == begin()) return true;
+                else --j;
+            }
+            return key_compare (key((link_type)j.node), k);
+        }
+
+        //find the parent pre for an equal key k
+        void _get_insert_equal_pos (const Key& k, link_type& cur, link_type& pre) {
+            pre = header;
+            cur = root();
+            while (cur != 0) {
+                pre = cur;
+                cur = key_compare (k, key(cur)) ? left (cur) : right (cur);
+            }
+        }
+
+        template <class V>
+        pair<iterator, bool> _insert_unique (V&& x) {
+            link_type cur, pre;
+            iterator j;
+            if (!_get_insert_unique_pos (KeyofValue()(x), cur, pre, j))
+                return pair<iterator, bool>(j, false);
+            return pair<iterator, bool>(_insert (cur, pre, std::forward<V>(x)), true);
+        }
+
+        template <class V>
+        iterator _insert_equal (V&& x) {
+            link_type cur, pre;
+            _get_insert_equal_pos (KeyofValue()(x), cur, pre);
+            return _insert (cur, pre, std::forward<V>(x));
+        }
+
 
-        link_type _copy (link_type x, link_type p);
+        //clone the subtree x under the parent p
+        link_type _copy (link_type x, link_type p) {
+            link_type top = clone_node (x);
+            top->parent = p;
+            if (x->right != 0)
+                top->right = _copy (right(x), top);
+            p = top;
+            x = left(x);
+            while (x != 0) {
+                link_type y = clone_node (x);
+                p->left = y;
+                y->parent = p;
+                if (x->right != 0)
+                    y->right = _copy (right(x), y);
+                p = y;
+                x = left(x);
+            }
+            return top;
+        }
+
+        //take over the nodes of x, header must be empty
+        void copy_from (const rb_tree& x) {
+            link_type xroot = (link_type) x.header->parent;
+            if (xroot != 0) {
+                root() = _copy (xroot, header);
+                leftmost() = minimum (root());
+                rightmost() = maximum (root());
+            }
+            node_num = x.node_num;
+        }
 
 
         void init () {
@@ -238,40 +333,53 @@ class rb_tree {
             color (header) = _red;
 
             root() = 0;
-            leftmost () = 0;
-            rightmost () = 0;
+            leftmost () = header;
+            rightmost () = header;
         }
 
     public:
-        rb_tree (const Compare& comp = Compare() )
-            : node_num (0), key_compare (comp) { init (); }
+        rb_tree (const Compare& comp = Compare(), const Alloc& a = Alloc() )
+            : rb_tree_node_allocator (a), node_num (0), key_compare (comp) { init (); }
+        //the copy uses the same allocator as x
+        rb_tree (const rb_tree& x)
+            : rb_tree_node_allocator (x.get_allocator()), node_num (0), key_compare (x.key_compare) {
+            init ();
+            copy_from (x);
+        }
+        //takes over the nodes and the allocator of x, x is left empty
+        rb_tree (rb_tree&& x)
+            : rb_tree_node_allocator (x.get_allocator()), node_num (0), key_compare (x.key_compare) {
+            init ();
+            swap (x);
+        }
 
         ~rb_tree () {
             clear ();
             put_node(header);
         }
 
+        //unlink z and restore the balance, z itself is not freed
         void _erase (base_ptr z) {
             base_ptr y = z;
             _color_type original_color = y->color;
             base_ptr x;
+            base_ptr x_parent;
             if (z->left == 0) {
-                if (z == leftmost()) leftmost() =(link_type) z->right;
                 x = z->right;
+                x_parent = z->parent;
                 rb_tree_transplant (z, z->right, header->parent);
             } else if (z->right == 0) {
-                if (z == rightmost()) rightmost() = (link_type)z->left;
                 x = z->left;
+                x_parent = z->parent;
                 rb_tree_transplant (z, z->left, header->parent);
             } else {
-                iterator j = iterator (z->right);
-                --j;
-                y = j.node;
+                y = rb_tree_base::minimum (z->right);
                 original_color = y->color;
                 x = y->right;
                 if (y->parent == z) {
-                    if (x != 0) x->parent = y;
+                    x_parent = y;
                 } else {
+                    x_parent = y->parent;
                     rb_tree_transplant (y, y->right, header->parent);
                     y->right = z->right;
                     y->right->parent = y;
@@ -281,16 +389,35 @@ class rb_tree {
                 y->left->parent = y;
                 y->color = z->color;
             }
+            //only a node with a null child can be leftmost or rightmost
+            if (z == leftmost ())
+                leftmost () = x != 0 ? minimum ((link_type)x) : (link_type)x_parent;
+            if (z == rightmost ())
+                rightmost () = x != 0 ? maximum ((link_type)x) : (link_type)x_parent;
             if (original_color == _black)
-                rb_erase_rebalance (x, header->parent);
-
+                rb_erase_rebalance (x, x_parent, header->parent);
         }
 
+        //the allocator is kept
         rb_tree<Key, Value, KeyofValue, Compare, Alloc>& operator= 
-            ( const rb_tree<Key, Value, KeyofValue, Compare, Alloc>& x);
+            ( const rb_tree<Key, Value, KeyofValue, Compare, Alloc>& x) {
+            if (this != &x) {
+                clear ();
+                key_compare = x.key_compare;
+                copy_from (x);
+            }
+            return *this;
+        }
+        //takes over the contents of x together with its allocator
+        rb_tree& operator= (rb_tree&& x) {
+            rb_tree tmp (std::move(x));
+            swap (tmp);
+            return *this;
+        }
 
     public:
         Compare key_comp () const { return key_compare; }
+        Alloc get_allocator () const { return rb_tree_node_allocator::get_allocator(); }
         iterator begin () { return leftmost(); }
         iterator end() { return header; }
         bool empty () const { return node_num == 0; }
@@ -298,48 +425,73 @@ class rb_tree {
         size_type max_size () const { return size_type(-1); }
         void clear () {
             free_node (root());
-            leftmost () = 0;
-            rightmost () = 0;
+            leftmost () = header;
+            rightmost () = header;
             root() = 0;
+            node_num = 0;
+        }
+        //exchange the trees, allocators included
+        void swap (rb_tree& x) {
+            node_allocator().swap_allocator (x.node_allocator());
+            tinySTL::swap (header, x.header);
+            tinySTL::swap (node_num, x.node_num);
+            tinySTL::swap (key_compare, x.key_compare);
         }
 
     public:
 
         typename tinySTL::pair<iterator, bool> insert_unique (const value_type& x) {
-            link_type pre = header;
-            link_type cur = root();
-            bool comp = true;
-            while (cur != 0) {
-                pre = cur;
-                comp = key_compare(KeyofValue()(x), key(cur));
-                cur = comp ? left (cur) : right (cur);
-            }
-            iterator j = iterator (pre);
-            if (comp) {
-                if (j == begin()) return pair<iterator, bool>(_insert (cur, pre, x), true);
-                else --j;
+            return _insert_unique (x);
+        }
+        typename tinySTL::pair<iterator, bool> insert_unique (value_type&& x) {
+            return _insert_unique (std::move(x));
+        }
+        //the node is built before the key is known, it is freed again
+        //when the key is there already
+        template <class... Args>
+        typename tinySTL::pair<iterator, bool> emplace_unique (Args&&... args) {
+            link_type z = create_node (std::forward<Args>(args)...);
+            link_type cur, pre;
+            iterator j;
+            if (!_get_insert_unique_pos (key(z), cur, pre, j)) {
+                destroy_node (z);
+                return pair<iterator, bool>(j, false);
             }
-
-            if (key_compare (key(j.node), KeyofValue()(x)))
-                return pair<iterator, bool>(_insert (cur, pre, x), true);
-            return pair<iterator, bool>(j, false);
+            return pair<iterator, bool>(_link (cur, pre, z), true);
         }
 
         iterator insert_equal (const value_type& x) {
-            link_type pre = header;
-            link_type cur = root();
-            bool comp = true;
-            while (cur != 0) {
-                pre = cur;
-                comp = key_compare (KeyofValue ()(x), key(cur));
-                cur = comp ? left (cur) : right (cur);
-            }
-            return _insert(cur, pre, x);
+            return _insert_equal (x);
+        }
+        iterator insert_equal (value_type&& x) {
+            return _insert_equal (std::move(x));
+        }
+        template <class... Args>
+        iterator emplace_equal (Args&&... args) {
+            link_type z = create_node (std::forward<Args>(args)...);
+            link_type cur, pre;
+            _get_insert_equal_pos (key(z), cur, pre);
+            return _link (cur, pre, z);
         }
         
         void erase (iterator x) {
             _erase (x.node);
             destroy_node ((link_type)x.node);
+            --node_num;
+        }
+
+        iterator find (const key_type& k) {
+            link_type pre = header;
+            link_type cur = root();
+            while (cur != 0) {
+                if (!key_compare (key(cur), k)) {
+                    pre = cur;
+                    cur = left (cur);
+                } else
+                    cur = right (cur);
+            }
+            iterator j = iterator (pre);
+            return (j == end() || key_compare (k, key(pre))) ? end() : j;
         }
 
 };
@@ -421,61 +573,65 @@ inline void rb_tree_rebalance (rb_tree_base* x, rb_tree_base*& root) {
     root->color = _black;
 }
 
-inline void rb_erase_rebalance (rb_tree_base* x, rb_tree_base*& root) {
-    while (x != root && x->color == _black) {
-        if (x == x->parent->left ) {
-            rb_tree_base* w = x->parent->right;
-            if ( w && w->color == _red) {
+//x takes the place of the removed node and may be null, so its parent
+//is tracked separately
+inline void rb_erase_rebalance (rb_tree_base* x, rb_tree_base* x_parent, rb_tree_base*& root) {
+    while (x != root && (x == 0 || x->color == _black)) {
+        if (x == x_parent->left ) {
+            rb_tree_base* w = x_parent->right;
+            if (w->color == _red) {
                 w->color = _black;
-                x->parent->color = _red;
-                rb_tree_rotate_left (x->parent, root);
-                w = x->parent->right;
+                x_parent->color = _red;
+                rb_tree_rotate_left (x_parent, root);
+                w = x_parent->right;
             }
             if ( (w->left == 0 || w->left->color == _black)
                     && (w->right == 0 || w->right->color == _black)) {
                 w->color = _red;
-                x = x->parent;
+                x = x_parent;
+                x_parent = x_parent->parent;
             } else {
                 if (w->right == 0 || w->right->color == _black) {
-                    if (w->left != 0) w->left->color = _black; //w->left won't be null
+                    w->left->color = _black;
                     w->color = _red;
                     rb_tree_rotate_right (w, root);
-                    w = x->parent->right;
+                    w = x_parent->right;
                 }
-                w->color = x->parent->color;
-                x->parent->color = _black;
+                w->color = x_parent->color;
+                x_parent->color = _black;
                 if (w->right != 0) w->right->color = _black;
-                rb_tree_rotate_left (x->parent, root);
-                x = root;
+                rb_tree_rotate_left (x_parent, root);
+                break;
             }
         } else {
-            rb_tree_base* w = x->parent->left;
-            if ( w && w->color == _red) {
+            rb_tree_base* w = x_parent->left;
+            if (w->color == _red) {
                 w->color = _black;
-                x->parent->color = _red;
-                rb_tree_rotate_right (x->parent, root);
-                w = x->parent->left;
+                x_parent->color = _red;
+                rb_tree_rotate_right (x_parent, root);
+                w = x_parent->left;
             }
             if ( (w->left == 0 || w->left->color == _black) 
                     && (w->right == 0 || w->right->color == _black)) {
                 w->color = _red;
-                x = x->parent;
+                x = x_parent;
+                x_parent = x_parent->parent;
             } else {
                 if (w->left == 0 ||w->left->color == _black) {
-                    if (w->right != 0) w->right->color = _black;
+                    w->right->color = _black;
                     w->color = _red;
                     rb_tree_rotate_left (w, root);
-                    w = x->parent->left;
+                    w = x_parent->left;
                 }
-                w->color = x->parent->color;
-                x->parent->color = _black;
+                w->color = x_parent->color;
+                x_parent->color = _black;
                 if (w->left != 0) w->left->color = _black;
-                rb_tree_rotate_right (x->parent, root);
-                x = root;
+                rb_tree_rotate_right (x_parent, root);
+                break;
             }
         }
-        x->color = _black;
     }
+    if (x != 0) x->color = _black;
 }
 
 inline void rb_tree_transplant (rb_tree_base* x, rb_tree_base* y, rb_tree_base*& root)  {
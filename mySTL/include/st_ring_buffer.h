@@ -0,0 +1,284 @@
+#ifndef ST_RING_BUFFER_H
+#define ST_RING_BUFFER_H
+#include <stddef.h>
+#include <new>
+#include <atomic>
+#include "st_allocator.h"
+#include "st_construct.h"
+#include "st_uninitialled.h"
+#include "st_algorithm.h"
+
+namespace tinySTL {
+    //who may use a ring_buffer at the same time
+    struct spsc_tag { };    //one producer thread and one consumer thread
+    struct mpmc_tag { };    //any number of both
+
+    //Bounded lock-free queue of a fixed power-of-two capacity. push and
+    //pop never block: they return false when the buffer is full or empty.
+    //push_n and pop_n move up to n elements at once.
+template <class T, class Concurrency = spsc_tag, class Alloc = SimpleAlloc>
+    class ring_buffer;
+
+    //a capacity of at least n, a power of two
+    inline size_t _ring_capacity (size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap *= 2;
+        return cap;
+    }
+
+    //The producer owns tail and the consumer owns head, each on its own
+    //cache line next to a cached copy of the other index, so the other
+    //line is only read when the cached copy says full or empty.
+template <class T, class Alloc>
+    class ring_buffer<T, spsc_tag, Alloc> : private simple_alloc<T, Alloc> {
+    private:
+        typedef simple_alloc<T, Alloc>  data_allocator_type;
+        enum {_CACHE_LINE = 64};
+        typedef std::atomic<size_t>     index;
+
+        //consumer line
+        alignas(_CACHE_LINE) index      head;
+        size_t                          cached_tail;
+        //producer line
+        alignas(_CACHE_LINE) index      tail;
+        size_t                          cached_head;
+        //read only
+        alignas(_CACHE_LINE) T*         slots;
+        size_t                          mask;
+
+        data_allocator_type& data_allocator () { return *this; }
+        //producer: free slots, at most n, looking at head only when needed
+        size_t room (size_t t, size_t n) {
+            if (mask + 1 - (t - cached_head) < n)
+                cached_head = head.load (std::memory_order_acquire);
+            size_t free = mask + 1 - (t - cached_head);
+            return free < n ? free : n;
+        }
+        //consumer: elements ready, at most n
+        size_t ready (size_t h, size_t n) {
+            if (cached_tail - h < n)
+                cached_tail = tail.load (std::memory_order_acquire);
+            size_t avail = cached_tail - h;
+            return avail < n ? avail : n;
+        }
+
+    public:
+        typedef T           value_type;
+        typedef size_t      size_type;
+
+        explicit ring_buffer (size_type capacity, const Alloc& a = Alloc())
+            : data_allocator_type(a), head(0), cached_tail(0), tail(0), cached_head(0) {
+                mask = _ring_capacity (capacity) - 1;
+                slots = data_allocator().allocate (mask + 1);
+            }
+        ring_buffer (const ring_buffer&) = delete;
+        ring_buffer& operator= (const ring_buffer&) = delete;
+        //neither end may be in use any more
+        ~ring_buffer () {
+            size_t t = tail.load (std::memory_order_relaxed);
+            for (size_t h = head.load (std::memory_order_relaxed); h != t; ++h)
+                destroy (&slots[h & mask]);
+            data_allocator().deallocate (slots);
+        }
+
+        //producer: construct an element from args at the tail, false when full
+        template <class... Args>
+        bool emplace (Args&&... args) {
+            size_t t = tail.load (std::memory_order_relaxed);
+            if (room (t, 1) == 0)
+                return false;
+            construct (&slots[t & mask], std::forward<Args>(args)...);
+            tail.store (t + 1, std::memory_order_release);
+            return true;
+        }
+        bool push (const T& x) { return emplace (x); }
+        bool push (T&& x) { return emplace (std::move(x)); }
+        //producer: copy up to n elements from items, returns how many went in
+        size_type push_n (const T* items, size_type n) {
+            size_t t = tail.load (std::memory_order_relaxed);
+            n = room (t, n);
+            //the free slots may wrap around the end of the array
+            size_t first = t & mask;
+            size_t part = mask + 1 - first < n ? mask + 1 - first : n;
+            uninitialed_copy (items, items + part, slots + first);
+            uninitialed_copy (items + part, items + n, slots);
+            tail.store (t + n, std::memory_order_release);
+            return n;
+        }
+        //consumer: move the element at the head into x, false when empty
+        bool pop (T& x) {
+            size_t h = head.load (std::memory_order_relaxed);
+            if (ready (h, 1) == 0)
+                return false;
+            T* slot = &slots[h & mask];
+            x = std::move (*slot);
+            destroy (slot);
+            head.store (h + 1, std::memory_order_release);
+            return true;
+        }
+        //consumer: move up to n elements into out, returns how many came out
+        size_type pop_n (T* out, size_type n) {
+            size_t h = head.load (std::memory_order_relaxed);
+            n = ready (h, n);
+            size_t first = h & mask;
+            size_t part = mask + 1 - first < n ? mask + 1 - first : n;
+            tinySTL::move (slots + first, slots + first + part, out);
+            destroy (slots + first, slots + first + part);
+            tinySTL::move (slots, slots + (n - part), out + part);
+            destroy (slots, slots + (n - part));
+            head.store (h + n, std::memory_order_release);
+            return n;
+        }
+
+        //number of elements, a snapshot when the other end is running.
+        //head is read first, a head that passed the tail read would wrap
+        size_type size () const {
+            size_t h = head.load (std::memory_order_acquire);
+            size_t t = tail.load (std::memory_order_acquire);
+            return t > h ? t - h : 0;
+        }
+        bool empty () const { return size() == 0; }
+        size_type capacity () const { return mask + 1; }
+        //Returns a copy of the allocator object associated with the buffer
+        Alloc get_allocator () const { return data_allocator_type::get_allocator(); }
+    };
+
+    //slot of the MPMC buffer, storage holds an element between a push and a pop
+template <class T>
+    struct _ring_cell {
+        std::atomic<size_t>     seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value () { return reinterpret_cast<T*>(storage); }
+    };
+
+    //Vyukov's bounded MPMC queue. Every cell carries a sequence number
+    //saying whose turn it is: the producer of position pos finds pos in
+    //it, the consumer finds pos + 1. Threads claim positions with a CAS on
+    //tail or head and then publish the cell by moving its sequence on.
+template <class T, class Alloc>
+    class ring_buffer<T, mpmc_tag, Alloc> : private simple_alloc<_ring_cell<T>, Alloc> {
+    private:
+        typedef _ring_cell<T>               cell;
+        typedef simple_alloc<cell, Alloc>   cell_allocator_type;
+        enum {_CACHE_LINE = 64};
+        typedef std::atomic<size_t>     index;
+
+        alignas(_CACHE_LINE) index      head;
+        alignas(_CACHE_LINE) index      tail;
+        //read only
+        alignas(_CACHE_LINE) cell*      cells;
+        size_t                          mask;
+
+        cell_allocator_type& cell_allocator () { return *this; }
+
+        //claim up to n positions from idx whose cells have sequence
+        //pos + lap, returns the first in pos and how many were claimed
+        size_t claim (index& idx, size_t lap, size_t n, size_t& pos) {
+            pos = idx.load (std::memory_order_relaxed);
+            for (;;) {
+                size_t k = 0;
+                for (; k < n; ++k) {
+                    size_t seq = cells[(pos + k) & mask].seq.load (std::memory_order_acquire);
+                    ptrdiff_t dif = (ptrdiff_t)(seq - (pos + k + lap));
+                    if (dif != 0) {
+                        //a cell of a later lap: another thread moved idx on
+                        if (dif > 0 && k == 0) k = n + 1;
+                        break;
+                    }
+                }
+                if (k == n + 1) {
+                    pos = idx.load (std::memory_order_relaxed);
+                    continue;
+                }
+                if (k == 0)
+                    return 0;
+                if (idx.compare_exchange_weak (pos, pos + k, std::memory_order_relaxed))
+                    return k;
+            }
+        }
+
+    public:
+        typedef T           value_type;
+        typedef size_t      size_type;
+
+        explicit ring_buffer (size_type capacity, const Alloc& a = Alloc())
+            : cell_allocator_type(a), head(0), tail(0) {
+                mask = _ring_capacity (capacity) - 1;
+                cells = cell_allocator().allocate (mask + 1);
+                for (size_t i = 0; i <= mask; ++i)
+                    new (&cells[i].seq) std::atomic<size_t>(i);
+            }
+        ring_buffer (const ring_buffer&) = delete;
+        ring_buffer& operator= (const ring_buffer&) = delete;
+        //no thread may use the buffer any more
+        ~ring_buffer () {
+            size_t t = tail.load (std::memory_order_relaxed);
+            for (size_t h = head.load (std::memory_order_relaxed); h != t; ++h)
+                destroy (cells[h & mask].value());
+            cell_allocator().deallocate (cells);
+        }
+
+        //construct an element from args at the tail, false when full
+        template <class... Args>
+        bool emplace (Args&&... args) {
+            size_t pos;
+            if (claim (tail, 0, 1, pos) == 0)
+                return false;
+            cell& c = cells[pos & mask];
+            construct (c.value(), std::forward<Args>(args)...);
+            c.seq.store (pos + 1, std::memory_order_release);
+            return true;
+        }
+        bool push (const T& x) { return emplace (x); }
+        bool push (T&& x) { return emplace (std::move(x)); }
+        //copy up to n elements from items into consecutive positions,
+        //returns how many went in
+        size_type push_n (const T* items, size_type n) {
+            size_t pos;
+            n = claim (tail, 0, n, pos);
+            for (size_t i = 0; i < n; ++i) {
+                cell& c = cells[(pos + i) & mask];
+                construct (c.value(), items[i]);
+                c.seq.store (pos + i + 1, std::memory_order_release);
+            }
+            return n;
+        }
+        //move the element at the head into x, false when empty
+        bool pop (T& x) {
+            size_t pos;
+            if (claim (head, 1, 1, pos) == 0)
+                return false;
+            cell& c = cells[pos & mask];
+            x = std::move (*c.value());
+            destroy (c.value());
+            c.seq.store (pos + mask + 1, std::memory_order_release);
+            return true;
+        }
+        //move up to n consecutive elements into out, returns how many came out
+        size_type pop_n (T* out, size_type n) {
+            size_t pos;
+            n = claim (head, 1, n, pos);
+            for (size_t i = 0; i < n; ++i) {
+                cell& c = cells[(pos + i) & mask];
+                out[i] = std::move (*c.value());
+                destroy (c.value());
+                c.seq.store (pos + i + mask + 1, std::memory_order_release);
+            }
+            return n;
+        }
+
+        //number of claimed elements, a snapshot when other threads are running
+        size_type size () const {
+            size_t h = head.load (std::memory_order_acquire);
+            size_t t = tail.load (std::memory_order_acquire);
+            return t > h ? t - h : 0;
+        }
+        bool empty () const { return size() == 0; }
+        size_type capacity () const { return mask + 1; }
+        //Returns a copy of the allocator object associated with the buffer
+        Alloc get_allocator () const { return cell_allocator_type::get_allocator(); }
+    };
+}
+
+#endif
@@ -0,0 +1,403 @@
+#ifndef ST_SMALL_VECTOR_H
+#define ST_SMALL_VECTOR_H
+#include "st_allocator.h"
+#include "st_uninitialled.h"
+#include "st_algorithm.h"
+#include <assert.h>
+#include <string.h>
+
+namespace tinySTL {
+    //vector that keeps up to N elements inside the object and only goes
+    //to the allocator once it holds more; it does not come back inline
+    //before shrink_to_fit
+    template <class T, size_t N, class Alloc = SimpleAlloc >
+class small_vector : private simple_alloc<T, Alloc> {
+    static_assert(N > 0, "small_vector needs room for at least one element");
+    private:
+        typedef simple_alloc<T, Alloc>  data_allocator_type;
+        typedef typename is_trivially_relocatable<T>::type  _relocatable;
+
+        T* _start;
+        T* _end;
+        T* _capacity;
+        alignas(T) unsigned char _buffer[N * sizeof(T)];
+
+    public:
+        typedef 	 T 				value_type;
+        typedef 	 T*				pointer;
+        typedef 	 const T* 		const_pointer;
+        typedef 	 T& 			reference;
+        typedef 	 const T&		const_reference;
+        typedef 	 size_t 		size_type;
+        typedef 	 ptrdiff_t		difference_type;
+        typedef 	 T* 			iterator;
+        typedef 	 const T*		const_iterator;
+
+    private:
+        data_allocator_type& data_allocator() { return *this; }
+        T* inline_storage() { return reinterpret_cast<T*>(_buffer); }
+        //start empty on the inline buffer
+        void inline_initialize() {
+            _start = _end = inline_storage();
+            _capacity = _start + N;
+        }
+        //give back heap storage, the elements must be destroyed already
+        void release() {
+            if(!is_inline())
+                data_allocator().deallocate(_start);
+            inline_initialize();
+        }
+        //capacity for at least n elements, growing by doubling
+        size_type grown_capacity(size_type n) const {
+            return max<size_type>(2 * capacity(), n);
+        }
+        //move the elements into storage for newcap >= size() elements
+        void relocate(size_type newcap) {
+            if(newcap <= N && !is_inline()) {
+                iterator old = _start;
+                iterator oldend = _end;
+                inline_initialize();
+                _end = uninitialed_move(old, oldend, _start);
+                destroy(old, oldend);
+                data_allocator().deallocate(old);
+            } else
+                relocate_aux(newcap, _relocatable());
+        }
+        //heap storage of relocatable elements follows a reallocate
+        void relocate_aux(size_type newcap, _true_type) {
+            size_type n = size();
+            if(is_inline()) {
+                iterator result = data_allocator().allocate(newcap);
+                memcpy((void*)result, (void*)_start, n * sizeof(T));
+                _start = result;
+            } else
+                _start = data_allocator().reallocate(_start, newcap);
+            _end = _start + n;
+            _capacity = _start + newcap;
+        }
+        void relocate_aux(size_type newcap, _false_type) {
+            iterator result = data_allocator().allocate(newcap);
+            iterator newend = uninitialed_move(_start, _end, result);
+            destroy(_start, _end);
+            if(!is_inline())
+                data_allocator().deallocate(_start);
+            _start = result;
+            _end = newend;
+            _capacity = _start + newcap;
+        }
+        //make room for n elements before pos in place, the gap is left
+        //partly uninitialized: [pos, pos+n) holds moved-from elements up to
+        //the old end, raw memory after it; returns the old end
+        iterator open_gap(iterator pos, size_type n) {
+            iterator oldend = _end;
+            size_type after = _end - pos;
+            if(after > n) {
+                uninitialed_move(_end - n, _end, _end);
+                backward_move<iterator>(pos, _end - n, _end - 1);
+            } else {
+                uninitialed_move(pos, _end, pos + n);
+            }
+            _end += n;
+            return oldend;
+        }
+        //insert the n elements of [first, last) before position
+        template <class ForwardIterator>
+        iterator insert_aux(const_iterator position, ForwardIterator first, ForwardIterator last, size_type n) {
+            iterator pos = const_cast<iterator>(position);
+            if(n == 0) return pos;
+            size_type index = pos - _start;
+            if(size() + n > capacity()) {
+                size_type newcap = grown_capacity(size() + n);
+                iterator result = data_allocator().allocate(newcap);
+                iterator newpos = uninitialed_move(_start, pos, result);
+                newpos = uninitialed_copy(first, last, newpos);
+                newpos = uninitialed_move(pos, _end, newpos);
+
+                destroy(_start, _end);
+                if(!is_inline())
+                    data_allocator().deallocate(_start);
+                _start = result;
+                _end = newpos;
+                _capacity = _start + newcap;
+                return _start + index;
+            }
+            iterator oldend = open_gap(pos, n);
+            for(; pos != oldend && first != last; ++pos, ++first)
+                *pos = *first;
+            uninitialed_copy(first, last, pos);
+            return _start + index;
+        }
+        //take over the elements and the storage of x, which is left empty
+        void steal(small_vector& x) {
+            if(x.is_inline()) {
+                _end = uninitialed_move(x._start, x._end, _start);
+                x.clear();
+            } else {
+                _start = x._start;
+                _end = x._end;
+                _capacity = x._capacity;
+                x.inline_initialize();
+            }
+        }
+
+    public:
+        //Returns whether the vector is empty
+        bool empty() const {return _end == _start;}
+        //Returns the number of elements in the vector.
+        size_type size() const {return (_end - _start);}
+        //Returns whether the elements are kept inside the object
+        bool is_inline() const {return _start == reinterpret_cast<const T*>(_buffer);}
+        //Returns the number of elements kept without a heap allocation
+        static size_type inline_capacity() {return N;}
+        //Returns an iterator pointing to the first element in the vector.
+        iterator begin() {return _start; }
+        const_iterator begin() const {return _start;}
+        const_iterator cbegin() const {return _start; }
+        //Returns an iterator referring to the past-the-end element in the vector container.
+        iterator end() { return _end; }
+        const_iterator end() const {return _end;}
+        const_iterator cend() const { return _end; }
+        //Constructs a vector, initializing its contents depending on the constructor version used
+        small_vector() { inline_initialize(); }
+        explicit small_vector(const Alloc& a) : data_allocator_type(a) { inline_initialize(); }
+        small_vector(size_type n, const value_type& x, const Alloc& a = Alloc()) : data_allocator_type(a) {
+            inline_initialize();
+            insert(end(), n, x);
+        }
+        //the copy uses the same allocator as x
+        small_vector(const small_vector& x) : data_allocator_type(x.get_allocator()) {
+            inline_initialize();
+            insert(end(), x.begin(), x.end());
+        }
+        //takes over the allocator of x, and its storage unless x is inline
+        small_vector(small_vector&& x) : data_allocator_type(x.get_allocator()) {
+            inline_initialize();
+            steal(x);
+        }
+        //Destroys the container object
+        ~small_vector() {
+            destroy(_start, _end);
+            if(!is_inline())
+                data_allocator().deallocate(_start);
+        }
+        //Returns a reference to the element at position n in the vector container.
+        reference operator[](size_type i) { return *(begin()+i);}
+        const_reference operator[](size_type i) const { return *(cbegin()+i);}
+        //Returns a reference to the last element in the vector.
+        reference back() { return *(end()-1); }
+        const_reference back() const { return *(cend()-1); }
+        //Returns a reference to the first element in the vector
+        reference front() { return *begin();}
+        const_reference front() const { return *cbegin();}
+        //Returns a reference to the element at position n in the vector
+        reference at(size_type i) {return *(begin()+i); }
+        const_reference at(size_type i) const {return *(cbegin()+i); }
+        //Return size of allocated storage capacity
+        size_type capacity() const {return (_capacity-_start); }
+        //Returns a direct pointer to the memory array used internally by the vector to store its owned elements.
+        pointer data() { return begin();}
+        const_pointer data() const {return cbegin(); }
+        //Returns a copy of the allocator object associated with the vector
+        Alloc get_allocator() const { return data_allocator_type::get_allocator(); }
+        //Assigns new contents, the allocator is kept
+        small_vector& operator=(const small_vector& x) {
+            if(this != &x)
+                assign(x.begin(), x.end());
+            return *this;
+        }
+        //takes over the contents of x together with its allocator
+        small_vector& operator=(small_vector&& x) {
+            if(this != &x) {
+                destroy(_start, _end);
+                release();
+                data_allocator() = x.data_allocator();
+                steal(x);
+            }
+            return *this;
+        }
+
+        //inserting new elements before the element at the specified position,
+        iterator insert(const_iterator position, const value_type& val) {
+            return emplace(position, val);
+        }
+        iterator insert(const_iterator position, value_type&& val) {
+            return emplace(position, std::move(val));
+        }
+        //The vector is extended by inserting n copies of val before the specified position
+        iterator insert(const_iterator position, size_type n, const value_type& val) {
+            iterator pos = const_cast<iterator>(position);
+            if(n == 0) return pos;
+            //val may be one of the elements
+            value_type tmp(val);
+            size_type index = pos - _start;
+            if(size() + n > capacity()) {
+                relocate(grown_capacity(size() + n));
+                pos = _start + index;
+            }
+            iterator oldend = open_gap(pos, n);
+            for(; pos != oldend && n > 0; ++pos, --n)
+                *pos = tmp;
+            _uninitialed_fill_n(pos, n, tmp);
+            return _start + index;
+        }
+        //The vector is extended by inserting the elements of [first, last) before the specified position
+        template <class InputIterator>
+        iterator insert(const_iterator position, InputIterator first, InputIterator last) {
+            return insert_aux(position, first, last, tinySTL::distance(first, last));
+        }
+        //inserts an element constructed in place from args before position
+        template <class... Args>
+        iterator emplace(const_iterator position, Args&&... args) {
+            iterator pos = const_cast<iterator>(position);
+            size_type index = pos - _start;
+            if(pos == _end && _end != _capacity) {
+                construct(_end, std::forward<Args>(args)...);
+                ++_end;
+                return pos;
+            }
+            //args may refer to an element that is about to move
+            value_type tmp(std::forward<Args>(args)...);
+            if(_end == _capacity) {
+                relocate(grown_capacity(size() + 1));
+                pos = _start + index;
+            }
+            if(pos == _end) {
+                construct(_end, std::move(tmp));
+            } else {
+                construct(_end, std::move(*(_end - 1)));
+                backward_move<iterator>(pos, _end - 1, _end - 1);
+                *pos = std::move(tmp);
+            }
+            ++_end;
+            return pos;
+        }
+
+        //Add element at the end
+        void push_back(const value_type& val) {
+            emplace_back(val);
+        }
+        void push_back(value_type&& val) {
+            emplace_back(std::move(val));
+        }
+        //Add an element constructed in place from args at the end
+        template <class... Args>
+        void emplace_back(Args&&... args) {
+            if(_end != _capacity) {
+                construct(_end, std::forward<Args>(args)...);
+                ++_end;
+            }
+            else
+                emplace(end(), std::forward<Args>(args)...);
+        }
+        // erase element at the end
+        void pop_back() {
+            assert(_end != _start);
+            --_end;
+            destroy(_end);
+        }
+        //Removes from the vector a single element (position)
+        iterator erase(iterator position) {
+            if(position+1 != _end)
+                tinySTL::move(position+1, end(), position);
+            --_end;
+            destroy(_end);
+            return position;
+        }
+        //Removes from the vector a range of elements ([first,last)).
+        iterator erase(iterator first, iterator last) {
+            size_type n = last - first;
+            if(n && last != end() )
+                tinySTL::move(last, _end, first);
+            destroy(_end-n, _end);
+            _end = _end - n;
+            return first;
+        }
+        //Removes all elements from the vector (which are destroyed), the storage is kept
+        void clear(){
+            destroy(_start, _end);
+            _end = _start;
+        }
+        //Exchanges the content of the container by the content of x, allocators included
+        void swap(small_vector& x) {
+            if(!is_inline() && !x.is_inline()) {
+                data_allocator().swap_allocator(x.data_allocator());
+                tinySTL::swap<iterator>(_start, x._start);
+                tinySTL::swap<iterator>(_end, x._end);
+                tinySTL::swap<iterator>(_capacity, x._capacity);
+            } else {
+                small_vector tmp(std::move(x));
+                x = std::move(*this);
+                *this = std::move(tmp);
+            }
+        }
+        //vector capacity be at least enough to contain n elements
+        void reserve (size_type n) {
+            if(capacity() < n)
+                relocate(n);
+        }
+        //Assigns new contents to the vector, replacing its current contents
+        template <class InputIterator>
+        void assign (InputIterator first, InputIterator last) {
+            clear();
+            insert(end(), first, last);
+        }
+        //Assigns new contents to the vector, replacing its current contents
+        void assign (size_type n, const value_type& val) {
+            value_type tmp(val);
+            clear();
+            insert(end(), n, tmp);
+        }
+        //Resizes the container so that it contains n elements
+        void resize (size_type n) {
+            resize(n, value_type());
+        }
+        //Resizes the container so that it contains n elements
+        void resize (size_type n, const value_type& val) {
+            if(size() < n)
+                insert(end(), n - size(), val);
+            else
+                erase(_start + n, _end);
+        }
+        //reduce its capacity to fit its size, back to the inline buffer if it fits
+        void shrink_to_fit() {
+            if(!is_inline() && capacity() != size())
+                relocate(size());
+        }
+        //Returns the maximum number of elements that the vector can hold.
+        size_type max_size() const {
+            return size_type(-1) / sizeof(value_type);
+        }
+    };
+
+    //comparison operation between the small_vector containers x and y
+    template <class T, size_t N, class Alloc>
+    inline bool operator==(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+       return (x.size() == y.size() && tinySTL::equal(x.begin(), x.end(), y.begin()));
+    }
+    template <class T, size_t N, class Alloc>
+    inline bool operator!=(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+       return !(x==y);
+    }
+    template <class T, size_t N, class Alloc>
+    inline bool operator<(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+       return tinySTL::lexicographical_compare(x.begin(), x.end(), y.begin(), y.end());
+    }
+    template <class T, size_t N, class Alloc>
+    inline bool operator<=(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+        return (x==y || x<y);
+    }
+    template <class T, size_t N, class Alloc>
+    inline bool operator>(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+        return tinySTL::lexicographical_compare(y.begin(), y.end(), x.begin(), x.end());
+    }
+    template <class T, size_t N, class Alloc>
+    inline bool operator>=(const small_vector<T,N,Alloc>& x, const small_vector<T,N,Alloc>& y) {
+        return (x==y || x>y);
+    }
+    //The contents of container x are exchanged with those of y
+    template <class T, size_t N, class Alloc>
+        inline void swap (small_vector<T,N,Alloc>& x, small_vector<T,N,Alloc>& y) {
+            x.swap(y);
+        }
+}
+#endif // ST_SMALL_VECTOR_H
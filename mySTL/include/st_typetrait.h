@@ -1,237 +1,53 @@
 #ifndef ST_TYPETRAIT_H
 #define ST_TYPETRAIT_H
+#include <type_traits>
 
 namespace tinySTL {
 
 struct _true_type {};
 struct _false_type {};
 
-template<class T>
-    struct _type_traits
-    {
-        typedef _false_type		has_trivial_default_constructor;
-        typedef _false_type		has_trivial_copy_constructor;
-        typedef _false_type		has_trivial_assignment_operator;
-        typedef _false_type		has_trivial_destructor;
-        typedef _false_type		is_POD_type;
-    };
-
-    template<>
-    struct _type_traits<bool>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<char>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned char>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<signed char>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<wchar_t>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<short>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned short>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<int>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned int>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<long>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned long>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<long long>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned long long>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<float>
+template<bool B>
+    struct _bool_type
     {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
+        typedef _true_type		type;
     };
     template<>
-    struct _type_traits<double>
+    struct _bool_type<false>
     {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<long double>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
+        typedef _false_type		type;
     };
 
-    template<class T>
-    struct _type_traits<T*>
+//Derived from the compiler's view of T, so user structs of scalars take the
+//fast paths like the built-in types. A type can still be specialized by
+//hand, e.g. to keep a type with side effects in its copy on the slow path.
+template<class T>
+    struct _type_traits
     {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
+        typedef typename _bool_type<std::is_trivially_default_constructible<T>::value>::type
+                                has_trivial_default_constructor;
+        typedef typename _bool_type<std::is_trivially_copy_constructible<T>::value>::type
+                                has_trivial_copy_constructor;
+        typedef typename _bool_type<std::is_trivially_copy_assignable<T>::value>::type
+                                has_trivial_assignment_operator;
+        typedef typename _bool_type<std::is_trivially_destructible<T>::value>::type
+                                has_trivial_destructor;
+        //copied as bytes, either into raw memory or over another value
+        typedef typename _bool_type<std::is_trivially_copyable<T>::value
+                                    && std::is_trivially_copy_constructible<T>::value
+                                    && std::is_trivially_copy_assignable<T>::value>::type
+                                is_POD_type;
     };
+
+    //A relocatable type may be moved to new storage as raw bytes, the old
+    //copy is then forgotten without running its destructor. PODs are
+    //relocatable; other types opt in by specializing, which is right for
+    //types that never point into themselves:
+    //  template<> struct is_trivially_relocatable<my_type> { typedef _true_type type; };
     template<class T>
-    struct _type_traits<const T*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<char*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<unsigned char*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<signed char*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<const char*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<const unsigned char*>
-    {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
-    };
-    template<>
-    struct _type_traits<const signed char*>
+    struct is_trivially_relocatable
     {
-        typedef _true_type		has_trivial_default_constructor;
-        typedef _true_type		has_trivial_copy_constructor;
-        typedef _true_type		has_trivial_assignment_operator;
-        typedef _true_type		has_trivial_destructor;
-        typedef _true_type		is_POD_type;
+        typedef typename _type_traits<T>::is_POD_type		type;
     };
 
 }
@@ -9,7 +9,7 @@ namespace tinySTL {
 
     template <class ForwardIterator, class Size, class T>
     inline ForwardIterator _uninitialed_fill_n_aux(ForwardIterator first, Size n, const T& x, _true_type){
-        return fill_n(first, n, x); //TODO
+        return tinySTL::fill_n(first, n, x);
     }
 
     template <class ForwardIterator, class Size, class T>
@@ -30,7 +30,7 @@ namespace tinySTL {
     template <class InputIterator, class ForwardIterator>
     inline ForwardIterator
         _uninitialed_copy_aux(InputIterator first, InputIterator end, ForwardIterator result, _true_type) {
-        return copy(first, end, result); //TODO
+        return tinySTL::copy(first, end, result);
     }
 
     template <class InputIterator, class ForwardIterator>
@@ -58,10 +58,39 @@ namespace tinySTL {
 
     }
 
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+        _uninitialed_move_aux(InputIterator first, InputIterator end, ForwardIterator result, _true_type) {
+        return tinySTL::copy(first, end, result);
+    }
+
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+        _uninitialed_move_aux(InputIterator first, InputIterator end, ForwardIterator result, _false_type) {
+        ForwardIterator cur = result;
+        for(; first != end; ++cur, ++first)
+            construct(&*cur, std::move(*first));
+        return cur;
+    }
+
+    template <class InputIterator, class ForwardIterator, class T>
+    inline ForwardIterator
+        _uninitialed_move(InputIterator first, InputIterator end, ForwardIterator result, T*) {
+        typedef typename _type_traits<T>::is_POD_type _is_POD_type;
+        return _uninitialed_move_aux(first, end, result, _is_POD_type());
+    }
+
+    //uninitialed_copy that moves the elements out of [first, end)
+    template <class InputIterator, class ForwardIterator>
+    inline ForwardIterator
+        uninitialed_move(InputIterator first, InputIterator end, ForwardIterator result) {
+        return _uninitialed_move(first, end, result, value_type(first));
+    }
+
     template <class ForwardIterator, class T>
     inline ForwardIterator
         _uninitialled_fill_aux(ForwardIterator first, ForwardIterator end, const T& x, _true_type) {
-        return fill(first, end, x); //TODO
+        return tinySTL::fill(first, end, x);
     }
 
     template <class ForwardIterator, class T>
@@ -75,7 +104,7 @@ namespace tinySTL {
 
     template <class ForwardIterator, class T, class T1>
     inline ForwardIterator
-        _uninitialled_fill(ForwardIterator first, ForwardIterator end, const T& x, T1 ) {
+        _uninitialled_fill(ForwardIterator first, ForwardIterator end, const T& x, T1*) {
         typedef typename _type_traits<T1>::is_POD_type _is_POD_type;
         return _uninitialled_fill_aux(first, end, x, _is_POD_type());
     }
@@ -86,6 +115,25 @@ namespace tinySTL {
         return _uninitialled_fill(first, end, x, value_type(first));
     }
 
+    template <class ForwardIterator>
+    inline void _uninitialed_default_init_aux(ForwardIterator, ForwardIterator, _true_type) { }
+
+    template <class ForwardIterator>
+    inline void _uninitialed_default_init_aux(ForwardIterator first, ForwardIterator end, _false_type) {
+        typedef typename iterator_traits<ForwardIterator>::value_type T;
+        for(; first != end; ++first)
+            new (&*first) T;
+    }
+
+    //default-initialize [first, end): types with a trivial default
+    //constructor are left as the memory was, others are default constructed
+    template <class ForwardIterator>
+    inline void uninitialed_default_init(ForwardIterator first, ForwardIterator end) {
+        typedef typename iterator_traits<ForwardIterator>::value_type T;
+        typedef typename _type_traits<T>::has_trivial_default_constructor _trivial;
+        _uninitialed_default_init_aux(first, end, _trivial());
+    }
+
 }
 #endif // UNINITIALLED_H
 
@@ -1,18 +1,23 @@
-#ifndef ST_tECTOR_H
+#ifndef ST_VECTOR_H
 #define ST_VECTOR_H
 #include "st_allocator.h"
 #include "st_uninitialled.h"
 #include "st_algorithm.h"
+#include "st_growth_policy.h"
 #include <assert.h>
+#include <string.h>
 
 namespace tinySTL {
-    template <class T, class Alloc = SimpleAlloc >
-class vector {
+    //Growth decides the capacity when the vector must grow, see st_growth_policy.h
+    template <class T, class Alloc = SimpleAlloc, class Growth = grow_double >
+class vector : private simple_alloc<T, Alloc> {
     private:
+        typedef simple_alloc<T, Alloc>  data_allocator_type;
+        typedef typename is_trivially_relocatable<T>::type  _relocatable;
+
         T* _start;
         T* _end;
         T* _capacity;
-        simple_alloc<T, Alloc> data_allocator;
 
     public:
         typedef 	 T 				value_type;
@@ -26,6 +31,8 @@ class vector {
         typedef 	 const T*		const_iterator;
 
     private:
+        //the allocator lives in the base, empty allocators take no space
+        data_allocator_type& data_allocator() { return *this; }
         //allocate, fill and initialize the vector
         void fill_and_initialize(size_type n, const T& x){
             iterator result = allocate_and_fill(n, x);
@@ -35,50 +42,64 @@ class vector {
         }
         //allocate and fill the vector
         iterator allocate_and_fill(size_type n, const T& x) {
-            iterator result = static_cast<iterator>(data_allocator.allocate(n));
+            iterator result = static_cast<iterator>(data_allocator().allocate(n));
             _uninitialed_fill_n(result, n, x);
             return result;
         }
-        //reallocate the vector and copy the contents from iterator from begin and end
-        template< class InputIterator>
-        InputIterator reallocate_and_copy(InputIterator begin, InputIterator end) {
-            size_type n = end-begin;
-            iterator result = data_allocator.reallocate(_start, n);
-            uninitialed_copy(begin, end, result);
-            return result;
-        }
         //allocate the vector and copy the contents from iterator from begin and end
         template <class InputIterator>
-        InputIterator allocate_and_copy(InputIterator begin, InputIterator end) {
+        iterator allocate_and_copy(InputIterator begin, InputIterator end) {
             size_type n = end - begin;
-            iterator result = data_allocator.allocate(n);
+            iterator result = data_allocator().allocate(n);
             uninitialed_copy(begin, end, result);
             return result;
         }
+        //give the vector storage for newcap >= size() elements; relocatable
+        //elements go along with a reallocate, which may move whole pages
+        void relocate(size_type newcap) {
+            relocate_aux(newcap, _relocatable());
+        }
+        void relocate_aux(size_type newcap, _true_type) {
+            size_type n = size();
+            _start = data_allocator().reallocate(_start, newcap);
+            _end = _start + n;
+            _capacity = _start + newcap;
+        }
+        void relocate_aux(size_type newcap, _false_type) {
+            iterator result = data_allocator().allocate(newcap);
+            iterator newend = uninitialed_move(_start, _end, result);
+
+            destroy(_start, _end);
+            data_allocator().deallocate(_start);
+
+            _start = result;
+            _end = newend;
+            _capacity = _start + newcap;
+        }
         //prepared for insert function and push_back function, insert element before position
         template <class InputIterator>
         iterator insert_aux(const_iterator position, InputIterator first, InputIterator last) {
             size_type n = last - first;
             iterator pos = const_cast<iterator>(position);
+            if(n == 0) return pos;
             if(_end + n < _capacity) {
                for(size_type i = 0; i < n; ++i)
                    construct(_end+i);
-               iterator result = backward_copy<iterator>(pos, _end, _end+n-1);
+               backward_move<iterator>(pos, _end, _end+n-1);
                for(size_type i = 0; i < n; ++i, ++first)
                    *(pos+i) = *first;
                _end += n;
                return (pos+n-1);
             } else {
-                size_type oldsize = _capacity - _start;
-                size_type newsize = oldsize + max<size_type>(oldsize, n);
-                iterator result = data_allocator.allocate(newsize);
-                iterator newpos = uninitialed_copy(_start, pos, result);
+                size_type newsize = Growth::grow(capacity(), size() + n, sizeof(T));
+                iterator result = data_allocator().allocate(newsize);
+                iterator newpos = uninitialed_move(_start, pos, result);
                 iterator respos = newpos;
                 newpos = uninitialed_copy(first, last, newpos);
-                newpos = uninitialed_copy(pos, _end, newpos);
+                newpos = uninitialed_move(pos, _end, newpos);
                 
                 destroy(_start, _end);
-                data_allocator.deallocate(_start);
+                data_allocator().deallocate(_start);
 
                 _start = result;
                 _end = newpos;
@@ -86,37 +107,57 @@ class vector {
                 return respos;
             }
         }
-        //prepared for insert function and push_back function, insert element before position
-        iterator insert_aux(const_iterator position, const value_type& val) {
+        //construct an element from args before position, the elements move
+        //to the new storage when the vector grows
+        template <class... Args>
+        iterator emplace_aux(const_iterator position, Args&&... args) {
             iterator pos = const_cast<iterator>(position);
             if(_end < _capacity) {
-                construct(_end, val);
-                iterator result = backward_copy<iterator>(pos, _end, _end);
-                //uninitialed_copy(position, _end, position+1);
-                *pos = val;
-                _end++;
+                if(pos == _end) {
+                    construct(_end, std::forward<Args>(args)...);
+                } else {
+                    //args may refer to an element that is about to move
+                    value_type tmp(std::forward<Args>(args)...);
+                    construct(_end, std::move(*(_end - 1)));
+                    backward_move<iterator>(pos, _end - 1, _end - 1);
+                    *pos = std::move(tmp);
+                }
+                ++_end;
                 return pos;
             }else {
-                size_type oldsize = _capacity - _start;
-                size_type newsize = oldsize==0?1:2*oldsize;
-
-                //iterator result = allocate_and_fill(newsize, val);
-                iterator result = data_allocator.allocate(newsize);
-                iterator newpos = uninitialed_copy(_start, pos, result);
-                construct(newpos, val);
-                iterator respos = newpos;
-                ++newpos;
-                newpos = uninitialed_copy(pos, _end, newpos);
-                
-                destroy(_start, _end);
-                data_allocator.deallocate(_start);
-
-                _start = result;
-                _end = newpos;
-                _capacity = _start + newsize;
-                return respos;
+                size_type newsize = Growth::grow(capacity(), size() + 1, sizeof(T));
+                return grow_and_emplace(pos, newsize, _relocatable(), std::forward<Args>(args)...);
             }         
         }
+        //the element is built before the storage moves, args may refer into it
+        template <class... Args>
+        iterator grow_and_emplace(iterator pos, size_type newsize, _true_type, Args&&... args) {
+            size_type index = pos - _start;
+            value_type tmp(std::forward<Args>(args)...);
+            relocate(newsize);
+            pos = _start + index;
+            if(pos != _end)
+                memmove((void*)(pos + 1), (void*)pos, (_end - pos) * sizeof(T));
+            construct(pos, std::move(tmp));
+            ++_end;
+            return pos;
+        }
+        template <class... Args>
+        iterator grow_and_emplace(iterator pos, size_type newsize, _false_type, Args&&... args) {
+            iterator result = data_allocator().allocate(newsize);
+            iterator respos = result + (pos - _start);
+            construct(respos, std::forward<Args>(args)...);
+            iterator newpos = uninitialed_move(_start, pos, result);
+            newpos = uninitialed_move(pos, _end, newpos + 1);
+            
+            destroy(_start, _end);
+            data_allocator().deallocate(_start);
+
+            _start = result;
+            _end = newpos;
+            _capacity = _start + newsize;
+            return respos;
+        }
     public:
         //Returns whether the vector is empty 
         bool empty() {return _end == _start;}
@@ -140,22 +181,30 @@ class vector {
         const_iterator crend() const {return cbegin()-1;}
         //Constructs a vector, initializing its contents depending on the constructor version used
         vector() : _start(0), _end(0), _capacity(0) {}
-        vector(size_type n, const value_type& x) { fill_and_initialize(n, x);}
-        vector(vector<T>& x) {
-            _start = allocate_and_copy<iterator>(x.begin(), x.end());
+        explicit vector(const Alloc& a) : data_allocator_type(a), _start(0), _end(0), _capacity(0) {}
+        vector(size_type n, const value_type& x, const Alloc& a = Alloc())
+            : data_allocator_type(a) { fill_and_initialize(n, x);}
+        //the copy uses the same allocator as x
+        vector(vector& x) : data_allocator_type(x.get_allocator()) {
+            _start = allocate_and_copy(x.begin(), x.end());
             _end = _start + x.size();
             _capacity = _start + x.size();
         }
-        vector(const vector<value_type>& x) {
-            _start = const_cast<iterator>(allocate_and_copy<const_iterator>(x.begin(), x.end()));
+        vector(const vector& x) : data_allocator_type(x.get_allocator()) {
+            _start = allocate_and_copy(x.begin(), x.end());
             _end = _start + x.size();
             _capacity = _start + x.size();
         }
+        //takes over the storage and the allocator of x, which is left empty
+        vector(vector&& x) : data_allocator_type(x.get_allocator()),
+            _start(x._start), _end(x._end), _capacity(x._capacity) {
+            x._start = x._end = x._capacity = 0;
+        }
         //Destroys the container object
         ~vector() {
             if(_capacity != 0) {
                 destroy(_start, _end); 
-                data_allocator.deallocate(_start);
+                data_allocator().deallocate(_start);
             }
         }
         //Returns a reference to the element at position n in the vector container.
@@ -176,53 +225,49 @@ class vector {
         pointer data() { return begin();}
         const_pointer data() const {return cbegin(); }
         //Returns a copy of the allocator object associated with the vector
-        Alloc get_allocator() { return data_allocator;}
+        Alloc get_allocator() const { return data_allocator_type::get_allocator(); }
         //Assigns new contents to the container, replacing its current contents, and modifying its size accordingly.
-        vector& operator=(const vector<T>& x) {
-            //const int size =x.size();
-            int newsize = x.size();
-            if(size() >= newsize) {
-                for(int i=0; i < newsize; ++i) {
-                    if(i < newsize)
-                        *(begin()+i) = *(x.begin()+i);
-                    else *(begin()+i) = value_type();
-                }
-                _end = begin() + newsize;
-
-            }else if(capacity() >= newsize ) {
-                for(int i=0; i< newsize;++i) {
-                    if(i <= capacity())
-                        *(begin()+i) = *(x.begin()+i);
-                    else {
-                        construct(begin()+i, *(x.begin()+i));
-                    }
-                }
-                _end = begin() + newsize;
+        vector& operator=(const vector& x) {
+            if(this == &x) return *this;
+            size_type newsize = x.size();
+            if(newsize > capacity()) {
+                iterator result = allocate_and_copy(x.begin(), x.end());
+                destroy(_start, _end);
+                data_allocator().deallocate(_start);
+                _start = result;
+                _capacity = _start + newsize;
+            } else if(size() >= newsize) {
+                iterator i = tinySTL::copy(x.begin(), x.end(), _start);
+                destroy(i, _end);
             } else {
-                _start = const_cast<iterator>(reallocate_and_copy<const_iterator>(x.begin(), x.end()));
-                _end = _start + newsize;
-                _capacity = _end;
+                tinySTL::copy(x.begin(), x.begin() + size(), _start);
+                uninitialed_copy(x.begin() + size(), x.end(), _end);
             }
-
+            _end = _start + newsize;
             return *this;
         }
-        //Assigns new contents to the container, replacing its current contents, and modifying its size accordingly.
-        vector& operator=(vector<T>& x) { //move
-            _start = reallocate_and_copy(x.begin(), x.end());
-            _end = _start + x.size();
-            _capacity = _end;
-            destroy(x.begin(), x.end());
-            //x.get_allocator().deallocate(x.begin());
+        //takes over the contents of x together with its allocator
+        vector& operator=(vector&& x) {
+            vector tmp(std::move(x));
+            swap(tmp);
             return *this;
         }
         
         //inserting new elements before the element at the specified position,
         iterator insert(const_iterator position, const value_type& val) {
-            return insert_aux(position, val);
+            return emplace_aux(position, val);
+        }
+        iterator insert(const_iterator position, value_type&& val) {
+            return emplace_aux(position, std::move(val));
+        }
+        //inserts an element constructed in place from args before position
+        template <class... Args>
+        iterator emplace(const_iterator position, Args&&... args) {
+            return emplace_aux(position, std::forward<Args>(args)...);
         }
         //The vector is extended by inserting new elements before the element at the specified position
         iterator insert(const_iterator position, size_type n, const value_type& val) {
-           vector<value_type> tmp(n, val);
+           vector tmp(n, val, get_allocator());
            return insert_aux<iterator>(position, tmp.begin(), tmp.end());
         }
         //The vector is extended by inserting new elements before the element at the specified position
@@ -232,17 +277,25 @@ class vector {
         }
         //The vector is extended by inserting new elements before the element at the specified position
         iterator insert(const_iterator position, value_type& val) {
-            return insert_aux(position, val); 
+            return emplace_aux(position, val); 
         }
         
         //Add element at the end
         void push_back(const value_type& val) {
+            emplace_back(val);
+        }
+        void push_back(value_type&& val) {
+            emplace_back(std::move(val));
+        }
+        //Add an element constructed in place from args at the end
+        template <class... Args>
+        void emplace_back(Args&&... args) {
             if(_end != _capacity) {
-                construct(_end, val);
+                construct(_end, std::forward<Args>(args)...);
                 ++_end;
             }
             else 
-                insert(end(), val);
+                emplace_aux(end(), std::forward<Args>(args)...);
         }
         // erase element at the end
         void pop_back() {
@@ -253,7 +306,7 @@ class vector {
         //ves from the vector either a single element (position) 
         iterator erase(iterator position) {
             if(position+1 != _end)
-                copy(position+1, end(), position);
+                tinySTL::move(position+1, end(), position);
             --_end;
             destroy(_end);
             return position;
@@ -261,8 +314,8 @@ class vector {
         //Removes from the vector a range of elements ([first,last)).
         iterator erase(iterator first, iterator last) {
             size_type n = last - first;
-            if(last != end() )
-                copy(last, _end, first);
+            if(n && last != end() )
+                tinySTL::move(last, _end, first);
             destroy(_end-n, _end);
             _end = _end - n;
             return first;
@@ -271,28 +324,17 @@ class vector {
         void clear(){
             erase(_start, _end);
         }
-        //Exchanges the content of the container by the content of x
-        void swap(vector<value_type>& x) {
+        //Exchanges the content of the container by the content of x, allocators included
+        void swap(vector& x) {
+            data_allocator().swap_allocator(x.data_allocator());
             tinySTL::swap<iterator>(_start, x._start);
             tinySTL::swap<iterator>(_end, x._end);
             tinySTL::swap<iterator>(_capacity, x._capacity);
         }
         //vector capacity be at least enough to contain n elements
         void reserve (size_type n) {
-            if(capacity() < n) {
-               size_type oldsize = _end - _start;
-            
-               iterator result = data_allocator.allocate(n);
-               iterator newstart = result;
-               result = uninitialed_copy(_start, _end, result);
-               
-               destroy(_start, _end);
-               data_allocator.deallocate(_start);
-
-               _start = newstart;
-               _end = result;
-               _capacity = _start + n; 
-            }
+            if(capacity() < n)
+               relocate(n);
         }
         //Assigns new contents to the vector, replacing its current contents
         template <class InputIterator>
@@ -300,15 +342,15 @@ class vector {
             size_type n = last - first;
             if(n <= capacity() ) {
                 destroy(_start, _end);
-                _end = uninitialed_fill(first, last, _start);
+                _end = uninitialed_copy(first, last, _start);
 
             } else {
-                iterator result = data_allocator.allocate(n);
+                iterator result = data_allocator().allocate(n);
                 iterator newstart = result;
-                result = uninitialed_fill(first,last, result);
+                result = uninitialed_copy(first,last, result);
 
                 destroy(_start, _end);
-                data_allocator.deallocate(_start);
+                data_allocator().deallocate(_start);
 
                 _start = newstart;
                 _end = result;
@@ -321,12 +363,12 @@ class vector {
                 destroy(_start, _end);
                 _end = _uninitialed_fill_n(_start, n, val);
             } else {
-                iterator result = data_allocator.allocate(n);
+                iterator result = data_allocator().allocate(n);
                 iterator newstart = result;
                 result = _uninitialed_fill_n(result, n, val);
 
                 destroy(_start, _end);
-                data_allocator.deallocate(_start);
+                data_allocator().deallocate(_start);
                 _start = newstart;
                 _end = result;
                 _capacity = _start + n;
@@ -343,27 +385,47 @@ class vector {
                     _end = _uninitialed_fill_n(_end, n-size(), val);
                 }
                 else {
-                    iterator result = data_allocator.allocate(n);
-                    iterator newstart = result;
-
-                    result = uninitialed_copy(_start, _end, result);
-                    result = _uninitialed_fill_n(result, n-size(), val);
-
-                    destroy(_start, _end);
-                    data_allocator.deallocate(_start);
-
-                    _start = newstart;
-                    _end = result;
-                    _capacity = _start + n;
+                    //val may be one of the elements
+                    value_type tmp(val);
+                    relocate(n);
+                    _end = _uninitialed_fill_n(_end, n-size(), tmp);
                 }
             }else if(size() > n) {
                 destroy(_start+n, _end);
                 _end = _start + n;
             }
         }
+        //Resizes the container to n elements, new elements are default-initialized:
+        //for PODs they keep whatever the memory held, to be written by the caller
+        void resize_uninitialized (size_type n) {
+            if(size() < n) {
+                if(capacity() < n)
+                    relocate(n);
+                uninitialed_default_init(_end, _start + n);
+                _end = _start + n;
+            } else if(size() > n) {
+                destroy(_start+n, _end);
+                _end = _start + n;
+            }
+        }
+        //Adds n default-initialized elements at the end and returns a pointer
+        //to the first of them; grows like push_back
+        pointer append_uninitialized (size_type n) {
+            if(size_type(_capacity - _end) < n)
+                relocate(Growth::grow(capacity(), size() + n, sizeof(T)));
+            iterator result = _end;
+            uninitialed_default_init(_end, _end + n);
+            _end += n;
+            return result;
+        }
         // reduce its capacity to fit its size
         void shrink_to_fit() {
-            reserve(size());
+            if(capacity() == size()) return;
+            if(size() == 0) {
+                data_allocator().deallocate(_start);
+                _start = _end = _capacity = 0;
+            } else
+                relocate(size());
         }
         //Returns the maximum number of elements that the vector can hold.
         size_type max_size() const {
@@ -372,33 +434,33 @@ class vector {
     };
     
     //comparison operation between the vector containers x and y
-    template <class T, class Alloc>
-    inline bool operator==(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator==(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
        return (x.size() == y.size() && equal(x.begin(), x.end(), y.begin()));
     }
-    template <class T, class Alloc>
-    inline bool operator!=(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator!=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
        return !(x==y); 
     }
-    template <class T, class Alloc>
-    inline bool operator<(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator<(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
        return lexicographical_compare(x.begin(), x.end(), y.begin(), y.end()); 
     }
-    template <class T, class Alloc>
-    inline bool operator<=(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator<=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
         return (x==y || x<y);
     }
-    template <class T, class Alloc>
-    inline bool operator>(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator>(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
         return lexicographical_compare(y.begin(), y.end(), x.begin(), x.end());
     }
-    template <class T, class Alloc>
-    inline bool operator>=(const vector<T,Alloc>& x, const vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+    inline bool operator>=(const vector<T, Alloc, Growth>& x, const vector<T, Alloc, Growth>& y) {
         return (x==y || x>y);
     }
     //The contents of container x are exchanged with those of y
-    template <class T, class Alloc>
-        inline void swap (vector<T, Alloc>& x, vector<T, Alloc>& y) {
+    template <class T, class Alloc, class Growth>
+        inline void swap (vector<T, Alloc, Growth>& x, vector<T, Alloc, Growth>& y) {
             x.swap(y);
         }
 }
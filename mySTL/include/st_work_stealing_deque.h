@@ -0,0 +1,180 @@
+#ifndef ST_WORK_STEALING_DEQUE_H
+#define ST_WORK_STEALING_DEQUE_H
+#include <stddef.h>
+#include <new>
+#include <atomic>
+#include <type_traits>
+#include "st_allocator.h"
+
+namespace tinySTL {
+    //Chase-Lev work-stealing deque, with the C++11 orderings of Le, Pop,
+    //Cohen and Zappa Nardelli, "Correct and Efficient Work-Stealing for
+    //Weak Memory Models" (PPoPP 2013). One owner thread pushes and pops at
+    //the bottom, any thread steals from the top.
+    //The elements live in a circular array which the owner doubles when it
+    //is full. A thief may still be reading the array that was replaced, so
+    //replaced arrays are retired on a list and freed with the deque, or by
+    //release_retired() once no steal can be running. Arrays double, so all
+    //the retired ones together are smaller than the live one.
+    //Elements are copied in and out of atomics, T has to be trivially
+    //copyable; tasks are usually pointers.
+template <class T, class Alloc = SimpleAlloc>
+    class work_stealing_deque : private simple_alloc<std::atomic<T>, Alloc> {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "work_stealing_deque elements are copied through std::atomic");
+    private:
+        struct ring {
+            ptrdiff_t           mask;
+            std::atomic<T>*     slots;
+            //the array this one replaced
+            ring*               retired;
+
+            T get (ptrdiff_t i) const { return slots[i & mask].load (std::memory_order_relaxed); }
+            void put (ptrdiff_t i, const T& x) { slots[i & mask].store (x, std::memory_order_relaxed); }
+        };
+        typedef simple_alloc<std::atomic<T>, Alloc>     data_allocator_type;
+        typedef simple_alloc<ring, Alloc>               ring_allocator_type;
+        enum {_CACHE_LINE = 64};
+
+        //thieves move top, the owner moves bottom; they sit on their own
+        //cache lines so a steal does not slow down the owner's pushes
+        std::atomic<ptrdiff_t>  top;
+        char                    _pad1[_CACHE_LINE - sizeof(std::atomic<ptrdiff_t>)];
+        std::atomic<ptrdiff_t>  bottom;
+        std::atomic<ring*>      array;
+        char                    _pad2[_CACHE_LINE - sizeof(std::atomic<ptrdiff_t>) - sizeof(std::atomic<ring*>)];
+
+        data_allocator_type& data_allocator () { return *this; }
+        ring_allocator_type ring_allocator () const { return ring_allocator_type (get_allocator()); }
+
+        //an array of cap slots, cap is a power of two
+        ring* new_ring (size_t cap, ring* retired) {
+            ring* r = ring_allocator().allocate();
+            r->mask = cap - 1;
+            r->slots = data_allocator().allocate (cap);
+            for (size_t i = 0; i < cap; ++i)
+                new (&r->slots[i]) std::atomic<T>();
+            r->retired = retired;
+            return r;
+        }
+        void delete_ring (ring* r) {
+            data_allocator().deallocate (r->slots);
+            ring_allocator().deallocate (r);
+        }
+        //owner only: a twice bigger array holding [t, b), the old one is retired
+        ring* grow (ring* a, ptrdiff_t t, ptrdiff_t b) {
+            ring* bigger = new_ring (2 * (a->mask + 1), a);
+            for (ptrdiff_t i = t; i != b; ++i)
+                bigger->put (i, a->get (i));
+            array.store (bigger, std::memory_order_release);
+            return bigger;
+        }
+        //a capacity of at least n, a power of two
+        static size_t round_capacity (size_t n) {
+            size_t cap = 2;
+            while (cap < n) cap *= 2;
+            return cap;
+        }
+
+    public:
+        typedef T               value_type;
+        typedef size_t          size_type;
+
+        explicit work_stealing_deque (size_type capacity = 64)
+            : top(0), bottom(0), array(0) {
+                array.store (new_ring (round_capacity (capacity), 0), std::memory_order_relaxed);
+            }
+        work_stealing_deque (size_type capacity, const Alloc& a)
+            : data_allocator_type(a), top(0), bottom(0), array(0) {
+                array.store (new_ring (round_capacity (capacity), 0), std::memory_order_relaxed);
+            }
+        work_stealing_deque (const work_stealing_deque&) = delete;
+        work_stealing_deque& operator= (const work_stealing_deque&) = delete;
+        //no thread may use the deque any more
+        ~work_stealing_deque () {
+            ring* r = array.load (std::memory_order_relaxed);
+            while (r) {
+                ring* retired = r->retired;
+                delete_ring (r);
+                r = retired;
+            }
+        }
+
+        //owner only: add x at the bottom, growing the array when it is full
+        void push (const T& x) {
+            ptrdiff_t b = bottom.load (std::memory_order_relaxed);
+            ptrdiff_t t = top.load (std::memory_order_acquire);
+            ring* a = array.load (std::memory_order_relaxed);
+            if (b - t > a->mask)
+                a = grow (a, t, b);
+            a->put (b, x);
+            std::atomic_thread_fence (std::memory_order_release);
+            bottom.store (b + 1, std::memory_order_relaxed);
+        }
+        //owner only: take the element at the bottom into x, false when empty
+        bool pop (T& x) {
+            ptrdiff_t b = bottom.load (std::memory_order_relaxed) - 1;
+            ring* a = array.load (std::memory_order_relaxed);
+            bottom.store (b, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            ptrdiff_t t = top.load (std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store (b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            T value = a->get (b);
+            if (t == b) {
+                //the last element, a thief may be taking it too
+                bool won = top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed);
+                bottom.store (b + 1, std::memory_order_relaxed);
+                if (!won)
+                    return false;
+            }
+            x = value;
+            return true;
+        }
+        //any thread: take the element at the top into x. False when the
+        //deque is empty or another thread took that element first
+        bool steal (T& x) {
+            ptrdiff_t t = top.load (std::memory_order_acquire);
+            std::atomic_thread_fence (std::memory_order_seq_cst);
+            ptrdiff_t b = bottom.load (std::memory_order_acquire);
+            if (t >= b)
+                return false;
+            ring* a = array.load (std::memory_order_acquire);
+            T value = a->get (t);
+            if (!top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed))
+                return false;
+            x = value;
+            return true;
+        }
+
+        //number of elements, exact only while no other thread is using the deque
+        size_type size () const {
+            ptrdiff_t b = bottom.load (std::memory_order_relaxed);
+            ptrdiff_t t = top.load (std::memory_order_relaxed);
+            return b > t ? size_type (b - t) : 0;
+        }
+        bool empty () const { return size() == 0; }
+        //owner only: slots in the live array
+        size_type capacity () const { return array.load (std::memory_order_relaxed)->mask + 1; }
+        //owner only, and only while no thread can be inside steal(): free
+        //the arrays replaced by growth
+        void release_retired () {
+            ring* a = array.load (std::memory_order_relaxed);
+            ring* r = a->retired;
+            a->retired = 0;
+            while (r) {
+                ring* retired = r->retired;
+                delete_ring (r);
+                r = retired;
+            }
+        }
+        //Returns a copy of the allocator object associated with the deque
+        Alloc get_allocator () const { return data_allocator_type::get_allocator(); }
+    };
+}
+
+#endif
@@ -0,0 +1,94 @@
+#include "../include/st_arena_alloc.h"
+#include "../include/st_vector.h"
+#include "../include/st_list.h"
+#include "../include/st_deque.h"
+#include "../include/st_rb_tree.h"
+#include <iostream>
+#include <assert.h>
+#include <string.h>
+
+//one counter per cache line
+struct alignas(64) counter {
+    long value;
+};
+
+bool aligned_to (const void* p, size_t align) {
+    return (size_t)p % align == 0;
+}
+
+//containers of over-aligned types get aligned storage from every Alloc
+void element_alignment () {
+    tinySTL::vector<counter> vec;
+    for (int i = 0; i < 1000; ++i) {
+        counter c = {i};
+        vec.push_back(c);
+        assert(aligned_to(&vec[0], 64));
+    }
+    assert(vec[999].value == 999);
+
+    tinySTL::deque<counter> deq;
+    for (int i = 0; i < 1000; ++i) {
+        counter c = {i};
+        deq.push_back(c);
+        deq.push_front(c);
+    }
+    for (size_t i = 0; i < deq.size(); ++i)
+        assert(aligned_to(&deq[i], 64));
+
+    tinySTL::list<counter> lst;
+    for (int i = 0; i < 100; ++i) {
+        counter c = {i};
+        lst.push_back(c);
+    }
+    for (tinySTL::list<counter>::iterator it = lst.begin(); it != lst.end(); ++it)
+        assert(aligned_to(&*it, 64));
+
+    tinySTL::vector<counter, tinySTL::arena_alloc<2> > arena_vec;
+    for (int i = 0; i < 100; ++i) {
+        counter c = {i};
+        arena_vec.push_back(c);
+        assert(aligned_to(&arena_vec[0], 64));
+    }
+}
+
+//an explicit alignment for buffers of ordinary types
+void explicit_alignment () {
+    typedef tinySTL::aligned<64> line_alloc;
+    tinySTL::vector<float, line_alloc> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back((float)i);
+        assert(aligned_to(&vec[0], 64));
+    }
+    tinySTL::vector<float, line_alloc> copy(vec);
+    assert(aligned_to(&copy[0], 64) && copy[999] == 999.0f);
+
+    tinySTL::deque<char, tinySTL::aligned<128> > deq;
+    for (int i = 0; i < 2000; ++i)
+        deq.push_back((char)i);
+    assert(aligned_to(&deq[0], 128));
+
+    //reallocate keeps the contents even when the block moves
+    line_alloc a;
+    char* p = (char*)a.allocate(100);
+    for (int i = 0; i < 100; ++i) p[i] = (char)i;
+    for (size_t n = 200; n < 100000; n *= 2) {
+        p = (char*)a.reallocate(p, n);
+        assert(aligned_to(p, 64));
+        for (int i = 0; i < 100; ++i) assert(p[i] == (char)i);
+    }
+    a.deallocate(p);
+
+    typedef tinySTL::aligned<4096, tinySTL::aligned<64> > page_alloc;
+    page_alloc page;
+    void* q = page.allocate(10);
+    assert(aligned_to(q, 4096));
+    page.deallocate(q);
+    assert((size_t)tinySTL::alloc_alignment<page_alloc>::value == 4096);
+}
+
+int main () {
+    element_alignment ();
+    explicit_alignment ();
+    std::cout << "aligned alloc ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,69 @@
+#define ST_ALLOC_TRACE
+#include "../include/st_vector.h"
+#include "../include/st_list.h"
+#include "../include/st_deque.h"
+#include <iostream>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//record the traffic of a few containers, then read the trace back
+int main () {
+    const char* path = "/tmp/st_alloc_trace_test.trace";
+    setenv("ST_ALLOC_TRACE_FILE", path, 1);
+    {
+        tinySTL::vector<int> vec;
+        for (int i = 0; i < 1000; ++i)
+            vec.push_back(i);
+        tinySTL::vector<int> copy;
+        copy = vec;
+        tinySTL::list<int> lst;
+        for (int i = 0; i < 100; ++i)
+            lst.push_back(i);
+        tinySTL::deque<int> deq;
+        for (int i = 0; i < 5000; ++i)
+            deq.push_front(i);
+    }
+    tinySTL::alloc_trace_recorder::instance().flush();
+
+    FILE* f = fopen(path, "rb");
+    assert(f && tinySTL::read_trace_header(f));
+    std::vector<bool> live;
+    size_t allocs = 0, frees = 0, created_by_realloc = 0, node_allocs = 0;
+    uint64_t last_time = 0;
+    tinySTL::trace_record r;
+    while (fread(&r, sizeof(r), 1, f) == 1) {
+        assert(r.time_ns >= last_time);
+        last_time = r.time_ns;
+        if (r.id >= live.size()) live.resize(r.id + 1, false);
+        switch (r.op) {
+        case tinySTL::TRACE_ALLOC:
+            assert(!live[r.id]);
+            live[r.id] = true;
+            ++allocs;
+            if (r.size == sizeof(tinySTL::_list_node<int>)) ++node_allocs;
+            break;
+        case tinySTL::TRACE_FREE:
+            assert(live[r.id]);
+            live[r.id] = false;
+            ++frees;
+            break;
+        case tinySTL::TRACE_REALLOC:
+            //a reallocate of a null pointer starts a block
+            if (!live[r.id]) ++created_by_realloc;
+            live[r.id] = true;
+            break;
+        default:
+            assert(false);
+        }
+    }
+    fclose(f);
+    remove(path);
+
+    assert(allocs + created_by_realloc == frees);
+    assert(node_allocs >= 100);
+    for (size_t i = 0; i < live.size(); ++i)
+        assert(!live[i]);
+    std::cout << allocs << " allocations traced" << std::endl;
+    return 0;
+}
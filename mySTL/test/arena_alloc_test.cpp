@@ -0,0 +1,105 @@
+#include "../include/st_arena_alloc.h"
+#include "../include/st_vector.h"
+#include "../include/st_list.h"
+#include "../include/st_deque.h"
+#include "../include/st_rb_tree.h"
+#include <iostream>
+#include <assert.h>
+
+typedef tinySTL::arena_alloc<0> request_alloc;
+
+//build a few throwaway structures as one request would
+void handle_request (int n) {
+    tinySTL::vector<int, request_alloc> vec;
+    for (int i = 0; i < n; ++i)
+        vec.push_back(i);
+    vec.insert(vec.begin(), (size_t)3, -1);
+    tinySTL::vector<int, request_alloc> vec2(vec);
+    assert(vec2.size() == (size_t)n + 3 && vec2[3] == 0 && vec2[n+2] == n-1);
+
+    tinySTL::list<int, request_alloc> lst;
+    for (int i = 0; i < n; ++i)
+        lst.push_front(i);
+    lst.sort();
+    assert(lst.front() == 0 && lst.back() == n-1);
+
+    tinySTL::deque<int, request_alloc> deq;
+    for (int i = 0; i < n; ++i) {
+        deq.push_back(i);
+        deq.push_front(-i);
+    }
+    assert(deq.size() == 2 * (size_t)n && deq[0] == -(n-1) && deq[2*n-1] == n-1);
+    deq.erase(deq.begin() + 1, deq.begin() + 3);
+    assert(deq.size() == 2 * (size_t)n - 2 && deq[1] == -(n-4));
+
+    tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int>, request_alloc> tree;
+    for (int i = 0; i < n; ++i)
+        tree.insert_unique((i * 7919) % n);
+    assert(tree.size() == (size_t)n);
+    int expect = 0;
+    for (tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int>, request_alloc>::iterator
+            it = tree.begin(); it != tree.end(); ++it)
+        assert(*it == expect++);
+}
+
+//two tenants, each container draws from the arena it was built with
+void tenants () {
+    tinySTL::arena pool_a, pool_b;
+    tinySTL::arena_ref ref_a(pool_a), ref_b(pool_b);
+
+    tinySTL::vector<int, tinySTL::arena_ref> vec_a(ref_a), vec_b(ref_b);
+    for (int i = 0; i < 100; ++i)
+        vec_a.push_back(i);
+    assert(pool_a.bytes_reserved() > 0 && pool_b.bytes_reserved() == 0);
+
+    tinySTL::vector<int, tinySTL::arena_ref> copy_a(vec_a);
+    assert(copy_a.get_allocator().get_arena() == &pool_a);
+    vec_a.swap(vec_b);
+    assert(vec_b.get_allocator().get_arena() == &pool_a && vec_b.size() == 100);
+    assert(vec_a.get_allocator().get_arena() == &pool_b && vec_a.size() == 0);
+
+    tinySTL::list<int, tinySTL::arena_ref> lst(ref_b);
+    lst.push_back(2);
+    lst.push_back(1);
+    lst.sort();
+    tinySTL::list<int, tinySTL::arena_ref> lst2(lst);
+    assert(lst2.get_allocator().get_arena() == &pool_b && lst2.front() == 1);
+
+    tinySTL::deque<int, tinySTL::arena_ref> deq((size_t)3, 7, ref_a);
+    tinySTL::deque<int, tinySTL::arena_ref> deq2(deq);
+    assert(deq2.get_allocator().get_arena() == &pool_a && deq2[2] == 7);
+
+    typedef tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int>, tinySTL::arena_ref> tree_type;
+    tree_type tree(tinySTL::less<int>(), ref_b);
+    tree.insert_unique(3);
+    tree.insert_unique(1);
+    tree_type tree2(tree);
+    assert(tree2.get_allocator().get_arena() == &pool_b && tree2.size() == 2 && *tree2.begin() == 1);
+
+    //empty allocators still cost nothing
+    assert(sizeof(tinySTL::vector<int>) == 3 * sizeof(int*));
+    assert(sizeof(tinySTL::list<int>) == sizeof(void*));
+    assert(sizeof(tinySTL::vector<int, tinySTL::arena_ref>) == 4 * sizeof(int*));
+}
+
+int main () {
+    for (int round = 0; round < 3; ++round) {
+        handle_request(1000);
+        assert(request_alloc::get_arena().bytes_reserved() > 0);
+        request_alloc::reset();
+        assert(request_alloc::get_arena().bytes_reserved() == 0);
+    }
+
+    tenants();
+
+    tinySTL::arena pool(4096);
+    char* p = (char*)pool.allocate(10);
+    p[0] = 'a';
+    char* q = (char*)pool.reallocate(p, 100);
+    assert(q == p && q[0] == 'a');
+    char* r = (char*)pool.allocate(8000);
+    q = (char*)pool.reallocate(q, 200);
+    assert(q != p && q[0] == 'a' && r != 0);
+    std::cout<<"arena_alloc ok"<<std::endl;
+    return 0;
+}
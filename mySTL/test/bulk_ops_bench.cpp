@@ -0,0 +1,55 @@
+#include "../include/st_vector.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//vector copy, assign and fill of ints from 64B to 1GB, in GB/s. The
+//loop columns are the element loops the algorithms used to run.
+
+typedef tinySTL::vector<int> ints;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//repeat f until about 0.2s or 4GB went by, return GB/s
+template <class F>
+static double rate(size_t bytes, F f) {
+    size_t reps = 0;
+    double begin = now(), sec;
+    do {
+        f();
+        ++reps;
+        sec = now() - begin;
+    } while (sec < 0.2 && reps * bytes < ((size_t)4 << 30));
+    return (double)reps * bytes / sec / 1e9;
+}
+
+static void loop_copy(const int* first, const int* last, int* result) {
+    for (; first != last; ++first, ++result)
+        *result = *first;
+}
+
+static void loop_fill(int* first, int* last, int x) {
+    for (; first != last; ++first)
+        *first = x;
+}
+
+int main(int argc, char** argv) {
+    size_t max_bytes = argc > 1 ? strtoul(argv[1], 0, 10) : ((size_t)1 << 30);
+    printf("%12s %10s %10s %10s %10s %10s\n", "bytes", "copy", "loop copy", "assign", "fill", "loop fill");
+    long check = 0;
+    for (size_t bytes = 64; bytes <= max_bytes; bytes *= 4) {
+        size_t n = bytes / sizeof(int);
+        ints src(n, 1), dst(n, 0);
+        double copy = rate(bytes, [&] { dst = src; check += dst[n / 2]; });
+        double lcopy = rate(bytes, [&] { loop_copy(src.begin(), src.end(), dst.begin()); check += dst[n / 2]; });
+        double assign = rate(bytes, [&] { dst.assign(src.begin(), src.end()); check += dst[n / 2]; });
+        double fill = rate(bytes, [&] { tinySTL::fill(dst.begin(), dst.end(), 0x01020304); check += dst[n / 2]; });
+        double lfill = rate(bytes, [&] { loop_fill(dst.begin(), dst.end(), 0x01020304); check += dst[n / 2]; });
+        printf("%12zu %10.2f %10.2f %10.2f %10.2f %10.2f\n", bytes, copy, lcopy, assign, fill, lfill);
+    }
+    return check == 0;
+}
@@ -0,0 +1,119 @@
+#include "../include/st_vector.h"
+#include "../include/st_deque.h"
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <assert.h>
+
+struct rgb {
+    unsigned char r, g, b;
+};
+struct quad {
+    int a, b, c, d;
+};
+
+//fill every length at every offset and compare with an element loop
+template <class T>
+void fill_check (const T& x) {
+    enum {MAX = 80};
+    T buf[MAX + 8], expect[MAX + 8];
+    for (size_t off = 0; off < 8; ++off) {
+        for (size_t n = 0; n <= MAX; ++n) {
+            memset ((void*)buf, 0x5a, sizeof(buf));
+            memset ((void*)expect, 0x5a, sizeof(expect));
+            for (size_t i = 0; i < n; ++i)
+                expect[off + i] = x;
+            if (n % 2) tinySTL::fill (buf + off, buf + off + n, x);
+            else assert (tinySTL::fill_n (buf + off, n, x) == buf + off + n);
+            assert (memcmp (buf, expect, sizeof(buf)) == 0);
+        }
+    }
+}
+
+bool contiguous (tinySTL::contiguous_iterator_tag) { return true; }
+bool contiguous (tinySTL::random_access_iterator_tag) { return false; }
+
+//equal, lexicographical_compare and backward_copy over contiguous ranges
+void compare_check () {
+    tinySTL::vector<int> v (100, 3);
+    tinySTL::deque<int> d (100, 3);
+    assert (contiguous (tinySTL::iterator_category (v.begin())));
+    assert (!contiguous (tinySTL::iterator_category (d.begin())));
+
+    tinySTL::vector<int> w (v);
+    assert (tinySTL::equal (v.begin(), v.end(), w.begin()));
+    w[99] = 4;
+    assert (!tinySTL::equal (v.begin(), v.end(), w.begin()));
+    assert (tinySTL::equal (v.begin(), v.begin(), w.end()));
+    assert (v < w && !(w < v) && v != w);
+
+    unsigned char a[] = {1, 2, 200}, b[] = {1, 2, 3, 4};
+    assert (!tinySTL::lexicographical_compare (a, a + 3, b, b + 4));
+    assert (tinySTL::lexicographical_compare (b, b + 4, a, a + 3));
+    assert (tinySTL::lexicographical_compare (b, b + 2, b, b + 3));
+    assert (!tinySTL::lexicographical_compare (b, b + 2, b, b + 2));
+    //signed chars and floats keep the element loop
+    char sa[] = {1, -1}, sb[] = {1, 1};
+    assert (tinySTL::lexicographical_compare (sa, sa + 2, sb, sb + 2));
+    double za[] = {0.0}, zb[] = {-0.0};
+    assert (tinySTL::equal (za, za + 1, zb));
+
+    int c[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    assert (tinySTL::backward_copy (c, c + 8, c + 9) == c + 1);
+    int shifted[10] = {0, 1, 0, 1, 2, 3, 4, 5, 6, 7};
+    assert (memcmp (c, shifted, sizeof(c)) == 0);
+    assert (tinySTL::backward_move (c + 2, c + 4, c + 1) == c - 1);
+    assert (c[0] == 0 && c[1] == 1 && c[2] == 0);
+    assert (tinySTL::backward_copy (c, c, c + 5) == c + 5);
+
+    tinySTL::copy (v.begin(), v.end(), d.begin());
+    tinySTL::backward_copy (d.begin(), d.begin() + 50, d.end() - 1);
+    assert (d[99] == 3 && d.size() == 100);
+}
+
+int main () {
+    compare_check ();
+    fill_check<char> ('q');
+    fill_check<short> (0x1234);
+    fill_check<int> (0x01020304);
+    fill_check<double> (3.5);
+    quad q = {1, 2, 3, 4};
+    fill_check<quad> (q);
+    rgb c = {1, 2, 3};
+    fill_check<rgb> (c);
+
+    //past the streaming threshold, from an odd start
+    tinySTL::vector<int> big (3 * 1024 * 1024, 0);
+    tinySTL::fill (big.begin() + 1, big.end() - 1, 7);
+    assert (big[0] == 0 && big[1] == 7 && big[big.size() - 2] == 7 && big.back() == 0);
+    for (size_t i = 1; i + 1 < big.size(); i += 4097)
+        assert (big[i] == 7);
+
+    //copies may overlap the way erase and insert need them to
+    int a[10] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    assert (tinySTL::copy (a + 2, a + 10, a) == a + 8);
+    int shifted[10] = {2, 3, 4, 5, 6, 7, 8, 9, 8, 9};
+    assert (memcmp (a, shifted, sizeof(a)) == 0);
+    const int* ca = a;
+    int b[3];
+    tinySTL::copy (ca, ca + 3, b);
+    assert (b[0] == 2 && b[2] == 4);
+
+    tinySTL::vector<int> v;
+    v.assign (a, a + 10);
+    tinySTL::vector<int> w (v);
+    assert (w == v && w.size() == 10 && w[9] == 9);
+    v.erase (v.begin(), v.begin() + 4);
+    assert (v.size() == 6 && v[0] == 6);
+
+    //other element types keep their element loops
+    tinySTL::vector<std::string> strs (5, std::string ("abc"));
+    tinySTL::fill (strs.begin(), strs.end(), std::string ("xyz"));
+    strs.assign (strs.begin() + 1, strs.begin() + 3);
+    assert (strs.size() == 2 && strs[1] == "xyz");
+    tinySTL::deque<std::string> deq (100, std::string (30, 'd'));
+    assert (deq[99] == std::string (30, 'd'));
+
+    std::cout << "bulk ops ok" << std::endl;
+    return 0;
+}
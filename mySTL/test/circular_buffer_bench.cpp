@@ -0,0 +1,93 @@
+#include "../include/st_circular_buffer.h"
+#include "../include/st_deque.h"
+#include <chrono>
+#include <stdio.h>
+
+using namespace std;
+
+//windowed aggregation over a stream of 4M ints, by window size. "slide"
+//keeps a running sum, one push and one pop per item: ns per item for a
+//fixed circular_buffer and for a deque. "rescan" also takes the maximum
+//of the whole window every window/4 items: ns per item for the
+//circular_buffer scanning array_one()/array_two() with pointers and for
+//the deque walking its iterators. Build with -O3, the pointer loops are
+//what the compiler vectorizes.
+
+typedef tinySTL::circular_buffer<int, tinySTL::SimpleAlloc, tinySTL::overwrite_oldest> ring;
+typedef tinySTL::deque<int> deq;
+
+enum {ITEMS = 1 << 22};
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int value(int i) { return (i * 2654435761u) >> 20; }
+
+static int max_of(const int* p, size_t n, int m) {
+    for (size_t i = 0; i < n; ++i)
+        m = p[i] > m ? p[i] : m;
+    return m;
+}
+
+static long slide_ring(size_t w, bool rescan) {
+    ring r(w);
+    long sum = 0, check = 0;
+    size_t every = w / 4, next = 0;
+    for (int i = 0; i < ITEMS; ++i) {
+        if (r.full())
+            sum -= r.front();
+        r.push_back(value(i));
+        sum += value(i);
+        check += sum;
+        if (rescan && ++next == every) {
+            next = 0;
+            ring::array_range one = r.array_one(), two = r.array_two();
+            check += max_of(two.first, two.second, max_of(one.first, one.second, 0));
+        }
+    }
+    return check;
+}
+
+static long slide_deque(size_t w, bool rescan) {
+    deq d;
+    long sum = 0, check = 0;
+    size_t every = w / 4, next = 0;
+    for (int i = 0; i < ITEMS; ++i) {
+        if (d.size() == w) {
+            sum -= d.front();
+            d.pop_front();
+        }
+        d.push_back(value(i));
+        sum += value(i);
+        check += sum;
+        if (rescan && ++next == every) {
+            next = 0;
+            int m = 0;
+            for (deq::iterator it = d.begin(); it != d.end(); ++it)
+                m = *it > m ? *it : m;
+            check += m;
+        }
+    }
+    return check;
+}
+
+template <class F>
+static double ns_per_item(F f, long& check) {
+    double t = now();
+    check += f();
+    return (now() - t) / ITEMS * 1e9;
+}
+
+int main() {
+    printf("%10s %12s %12s %12s %12s\n", "window", "slide ring", "slide deque", "rescan ring", "rescan deque");
+    long check = 0;
+    for (size_t w = 64; w <= ((size_t)1 << 20); w *= 8) {
+        double sr = ns_per_item([&] { return slide_ring(w, false); }, check);
+        double sd = ns_per_item([&] { return slide_deque(w, false); }, check);
+        double rr = ns_per_item([&] { return slide_ring(w, true); }, check);
+        double rd = ns_per_item([&] { return slide_deque(w, true); }, check);
+        printf("%10zu %12.2f %12.2f %12.2f %12.2f\n", w, sr, sd, rr, rd);
+    }
+    return check == 0;
+}
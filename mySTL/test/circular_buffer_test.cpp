@@ -0,0 +1,147 @@
+#include "../include/st_circular_buffer.h"
+#include "../include/st_vector.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <string>
+#include <deque>
+#include <stdlib.h>
+#include <assert.h>
+
+//same() and also the two runs, the iterators and both ends
+template <class Buffer, class Ref>
+void same_runs (const Buffer& b, const Ref& ref) {
+    same (b, ref);
+    assert (b.size() <= b.capacity() && (size_t)(b.end() - b.begin()) == ref.size());
+    typename Buffer::const_array_range one = b.array_one(), two = b.array_two();
+    assert (one.second + two.second == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i) {
+        assert (b.begin()[i] == ref[i]);
+        assert (i < one.second ? one.first[i] == ref[i] : two.first[i - one.second] == ref[i]);
+    }
+    if (!ref.empty())
+        assert (b.front() == ref.front() && b.back() == ref.back());
+}
+
+//random pushes and pops at both ends of a growing buffer
+template <class T>
+void growing () {
+    T* tag = 0;
+    tinySTL::circular_buffer<T> b;
+    std::deque<T> ref;
+    for (int round = 0; round < 20000; ++round) {
+        int op = rand () % 6;
+        if (op < 2) {
+            b.push_back (make (round, tag));
+            ref.push_back (make (round, tag));
+        } else if (op < 4) {
+            b.emplace_front (make (round, tag));
+            ref.push_front (make (round, tag));
+        } else if (ref.empty ()) {
+        } else if (op == 4) {
+            b.pop_back ();
+            ref.pop_back ();
+        } else {
+            b.pop_front ();
+            ref.pop_front ();
+        }
+        if (round % 97 == 0)
+            same_runs (b, ref);
+    }
+    same_runs (b, ref);
+    //an element of the buffer pushed into it while it grows
+    while (!b.full ())
+        b.push_back (make (-1, tag));
+    b.push_back (b.front ());
+    assert (b.back() == b.front());
+    size_t mid = b.size() / 2;
+    b.push_front (b[mid]);
+    assert (b.front() == b[mid + 1]);
+}
+
+//a full window keeps the newest elements, from either end
+template <class T>
+void window () {
+    T* tag = 0;
+    tinySTL::circular_buffer<T, tinySTL::SimpleAlloc, tinySTL::overwrite_oldest> b (7);
+    std::deque<T> ref;
+    for (int i = 0; i < 100; ++i) {
+        b.push_back (make (i, tag));
+        ref.push_back (make (i, tag));
+        if (ref.size() > 7) ref.pop_front ();
+        same_runs (b, ref);
+    }
+    for (int i = 0; i < 10; ++i) {
+        b.push_front (make (-i, tag));
+        ref.push_front (make (-i, tag));
+        ref.pop_back ();
+        same_runs (b, ref);
+    }
+    b.push_back (b.front ());
+    ref.push_back (ref.front ());
+    ref.pop_front ();
+    same_runs (b, ref);
+    assert (b.capacity() == 7);
+
+    tinySTL::circular_buffer<T, tinySTL::SimpleAlloc, tinySTL::overwrite_oldest> none;
+    none.push_back (make (1, tag));
+    assert (none.empty ());
+}
+
+int main () {
+    growing<int> ();
+    growing<std::string> ();
+    window<int> ();
+    window<std::string> ();
+
+    //the runs of a wrapped buffer, and the algorithms walking them
+    tinySTL::circular_buffer<int> b (10);
+    for (int i = 0; i < 10; ++i)
+        b.push_back (i);
+    for (int i = 0; i < 6; ++i) {
+        b.pop_front ();
+        b.push_back (10 + i);
+    }
+    assert (b.full () && b.array_one().first == &b[0] && b.array_one().second == 4
+            && b.array_two().second == 6 && b.array_two().first == &b[4]);
+    tinySTL::vector<int> v (10, 0);
+    tinySTL::copy (b.begin(), b.end(), v.begin());
+    for (int i = 0; i < 10; ++i)
+        assert (v[i] == 6 + i);
+    assert (tinySTL::equal (b.begin(), b.end(), v.begin()));
+    tinySTL::fill (b.begin() + 2, b.end() - 1, 7);
+    assert (b[1] == 7 && b[2] == 7 && b[8] == 7 && b[9] == 15);
+    tinySTL::copy (v.begin(), v.end(), b.begin());
+    tinySTL::backward_copy (b.begin(), b.end() - 3, b.end() - 1);
+    for (int i = 0; i < 10; ++i)
+        assert (b[i] == (i < 3 ? 6 + i : 3 + i));
+    tinySTL::copy (v.begin(), v.end(), b.begin());
+
+    //copies start at slot 0, linearize gathers the runs
+    tinySTL::circular_buffer<int> c (b);
+    assert (c == b && c.array_two().second == 0 && c.capacity() == 10);
+    c.pop_back ();
+    assert (c != b && c < b);
+    c = b;
+    assert (c == b);
+    int* p = b.linearize ();
+    assert (b.array_two().second == 0 && b.array_one().second == 10 && p == &b[0]);
+    for (int i = 0; i < 10; ++i)
+        assert (p[i] == 6 + i);
+
+    //capacity changes keep the elements, set_capacity drops from the front
+    b.reserve (20);
+    assert (b.capacity() == 20 && b.size() == 10 && b[0] == 6);
+    b.set_capacity (4);
+    assert (b.capacity() == 4 && b.size() == 4 && b[0] == 12 && b.back() == 15);
+    tinySTL::circular_buffer<int> d (std::move (b));
+    assert (b.empty () && b.capacity() == 0 && d.size() == 4);
+    b.swap (d);
+    assert (b.size() == 4 && d.empty ());
+    d = std::move (b);
+    assert (d.size() == 4 && d.front() == 12);
+    d.clear ();
+    assert (d.empty () && d.capacity() == 4);
+
+    std::cout << "circular_buffer ok" << std::endl;
+    return 0;
+}
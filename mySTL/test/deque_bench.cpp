@@ -0,0 +1,66 @@
+#include "../include/st_vector.h"
+#include "../include/st_deque.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//copy, fill and equal of ints over vector and deque from 4KB to 256MB,
+//in GB/s. The loop columns walk the deque iterators one element at a
+//time, the way the algorithms did before they went buffer by buffer.
+
+typedef tinySTL::vector<int> ints;
+typedef tinySTL::deque<int> deq;
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//repeat f until about 0.2s or 4GB went by, return GB/s
+template <class F>
+static double rate(size_t bytes, F f) {
+    size_t reps = 0;
+    double begin = now(), sec;
+    do {
+        f();
+        ++reps;
+        sec = now() - begin;
+    } while (sec < 0.2 && reps * bytes < ((size_t)4 << 30));
+    return (double)reps * bytes / sec / 1e9;
+}
+
+template <class In, class Out>
+static void loop_copy(In first, In last, Out result) {
+    for (; first != last; ++first, ++result)
+        *result = *first;
+}
+
+template <class It>
+static void loop_fill(It first, It last, int x) {
+    for (; first != last; ++first)
+        *first = x;
+}
+
+int main(int argc, char** argv) {
+    size_t max_bytes = argc > 1 ? strtoul(argv[1], 0, 10) : ((size_t)1 << 28);
+    printf("%12s %10s %10s %10s %10s %10s %10s %10s\n", "bytes", "vec copy", "deq copy", "loop copy",
+           "vec fill", "deq fill", "loop fill", "deq equal");
+    long check = 0;
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4) {
+        size_t n = bytes / sizeof(int);
+        ints vsrc(n, 1), vdst(n, 0);
+        deq dsrc(n, 1), ddst(n, 0);
+        double vcopy = rate(bytes, [&] { tinySTL::copy(vsrc.begin(), vsrc.end(), vdst.begin()); check += vdst[n / 2]; });
+        double dcopy = rate(bytes, [&] { tinySTL::copy(dsrc.begin(), dsrc.end(), ddst.begin()); check += ddst[n / 2]; });
+        double lcopy = rate(bytes, [&] { loop_copy(dsrc.begin(), dsrc.end(), ddst.begin()); check += ddst[n / 2]; });
+        double vfill = rate(bytes, [&] { tinySTL::fill(vdst.begin(), vdst.end(), 7); check += vdst[n / 2]; });
+        double dfill = rate(bytes, [&] { tinySTL::fill(ddst.begin(), ddst.end(), 7); check += ddst[n / 2]; });
+        double lfill = rate(bytes, [&] { loop_fill(ddst.begin(), ddst.end(), 7); check += ddst[n / 2]; });
+        tinySTL::fill(dsrc.begin(), dsrc.end(), 7);
+        double dequal = rate(bytes, [&] { check += tinySTL::equal(dsrc.begin(), dsrc.end(), ddst.begin()); });
+        printf("%12zu %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f %10.2f\n", bytes, vcopy, dcopy, lcopy,
+               vfill, dfill, lfill, dequal);
+    }
+    return check == 0;
+}
@@ -0,0 +1,75 @@
+#include "../include/st_deque.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//deque<int> with buffer budgets from 256B to 64KB: ns per operator[] read
+//in index order and in a scattered order, per element of an iterator
+//walk, and per push_back plus pop_front through a queue of 4096
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum {N = 1 << 22, QUEUE = 4096};
+
+static long check = 0;
+
+template <size_t Bytes>
+static void run() {
+    typedef tinySTL::deque<int, tinySTL::SimpleAlloc, Bytes> deq;
+    deq d;
+    for (int i = 0; i < N; ++i)
+        d.push_back(i);
+    //start in the middle of a buffer so every index carries an offset
+    for (int i = 0; i < 3; ++i)
+        d.pop_front();
+    size_t n = d.size();
+
+    double t = now();
+    for (int rep = 0; rep < 4; ++rep)
+        for (size_t i = 0; i < n; ++i)
+            check += d[i];
+    double index = (now() - t) / (4.0 * n) * 1e9;
+
+    t = now();
+    size_t pos = 0;
+    for (size_t i = 0; i < n; ++i) {
+        pos = (pos + 40503) & (N / 2 - 1);
+        check += d[pos];
+    }
+    double scatter = (now() - t) / n * 1e9;
+
+    t = now();
+    for (int rep = 0; rep < 4; ++rep)
+        for (typename deq::iterator it = d.begin(); it != d.end(); ++it)
+            check += *it;
+    double walk = (now() - t) / (4.0 * n) * 1e9;
+
+    deq q;
+    for (int i = 0; i < QUEUE; ++i)
+        q.push_back(i);
+    t = now();
+    for (int i = 0; i < N; ++i) {
+        q.push_back(i);
+        check += q.front();
+        q.pop_front();
+    }
+    double queue = (now() - t) / N * 1e9;
+
+    printf("%8zu %8zu %10.2f %10.2f %10.2f %10.2f\n", Bytes, deq::iterator::buffer_size(),
+           index, scatter, walk, queue);
+}
+
+int main() {
+    printf("%8s %8s %10s %10s %10s %10s\n", "bytes", "elems", "index", "scatter", "walk", "queue");
+    run<256>();
+    run<512>();
+    run<1024>();
+    run<4096>();
+    run<16384>();
+    run<65536>();
+    return check == 0;
+}
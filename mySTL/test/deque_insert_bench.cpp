@@ -0,0 +1,67 @@
+#include "../include/st_vector.h"
+#include "../include/st_deque.h"
+#include <chrono>
+#include <stdio.h>
+
+using namespace std;
+
+//insert k ints in the middle of 1M and erase them again, in us per pair
+//and in GB/s of elements shifted. The single column inserts the k ints
+//one insert at a time, "-" where k is too large for that to finish;
+//vector is the same pair on a vector.
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum {N = 1 << 20};
+
+template <class F>
+static double per_call(F f) {
+    size_t reps = 0;
+    double begin = now(), sec;
+    do {
+        f();
+        ++reps;
+        sec = now() - begin;
+    } while (sec < 0.3);
+    return sec / reps;
+}
+
+int main() {
+    tinySTL::deque<int> d;
+    tinySTL::vector<int> v;
+    for (int i = 0; i < N; ++i) {
+        d.push_back(i);
+        v.push_back(i);
+    }
+    long check = 0;
+    printf("%8s %10s %10s %10s %10s %10s\n", "k", "range us", "GB/s", "single us", "vector us", "GB/s");
+    for (int k = 1; k <= 4096; k *= 8) {
+        tinySTL::vector<int> block(k, -1);
+        //each insert and each erase shifts the shorter half
+        double bytes = 2.0 * (N / 2) * sizeof(int);
+        double range = per_call([&] {
+            d.insert(d.begin() + N / 2 - 7, block.begin(), block.end());
+            d.erase(d.begin() + N / 2 - 7, d.begin() + N / 2 - 7 + k);
+            check += d[N / 2];
+        });
+        double single = k > 512 ? 0 : per_call([&] {
+            for (int i = 0; i < k; ++i)
+                d.insert(d.begin() + N / 2 - 7 + i, -1);
+            d.erase(d.begin() + N / 2 - 7, d.begin() + N / 2 - 7 + k);
+            check += d[N / 2];
+        });
+        double vec = per_call([&] {
+            v.insert(v.begin() + N / 2 - 7, block.begin(), block.end());
+            v.erase(v.begin() + N / 2 - 7, v.begin() + N / 2 - 7 + k);
+            check += v[N / 2];
+        });
+        char single_us[16] = "-";
+        if (single > 0)
+            snprintf(single_us, sizeof(single_us), "%.1f", single * 1e6);
+        printf("%8d %10.1f %10.2f %10s %10.1f %10.2f\n", k, range * 1e6, bytes / range / 1e9,
+               single_us, vec * 1e6, bytes / vec / 1e9);
+    }
+    return check == 0;
+}
@@ -0,0 +1,99 @@
+#include "../include/st_deque.h"
+#include "../include/st_list.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <assert.h>
+
+//hands out the values of an array one pass only
+template <class T>
+struct one_pass : public tinySTL::iterator<tinySTL::input_iterator_tag, T> {
+    const T* p;
+    explicit one_pass (const T* p) : p(p) { }
+    const T& operator* () const { return *p; }
+    one_pass& operator++ () { ++p; return *this; }
+    bool operator!= (const one_pass& x) const { return p != x.p; }
+};
+
+//ranges and fills of every length at every position, on both sides of
+//the middle, against a std::vector
+template <class T, size_t Bytes>
+void check () {
+    T* tag = 0;
+    for (int round = 0; round < 400; ++round) {
+        tinySTL::deque<T, tinySTL::SimpleAlloc, Bytes> d;
+        std::vector<T> ref;
+        int n = rand () % 100;
+        for (int i = 0; i < n; ++i) {
+            d.push_back (make (i, tag));
+            ref.push_back (make (i, tag));
+        }
+        for (int i = 0; i < n / 3; ++i) {
+            d.pop_front ();
+            ref.erase (ref.begin());
+        }
+        std::vector<T> src;
+        int count = rand () % 60;
+        for (int i = 0; i < count; ++i)
+            src.push_back (make (1000 + i, tag));
+
+        size_t pos = rand () % (ref.size() + 1);
+        typename tinySTL::deque<T, tinySTL::SimpleAlloc, Bytes>::iterator it;
+        switch (round % 4) {
+        case 0:
+            it = d.insert (d.begin() + pos, count, make (-1, tag));
+            assert (it == d.begin() + pos);
+            ref.insert (ref.begin() + pos, count, make (-1, tag));
+            break;
+        case 1:
+            it = d.insert (d.begin() + pos, src.data(), src.data() + count);
+            assert (it == d.begin() + pos);
+            ref.insert (ref.begin() + pos, src.begin(), src.end());
+            break;
+        case 2: {
+            tinySTL::list<T> l;
+            for (int i = 0; i < count; ++i)
+                l.push_back (src[i]);
+            d.insert (d.begin() + pos, l.begin(), l.end());
+            ref.insert (ref.begin() + pos, src.begin(), src.end());
+            break;
+        }
+        default:
+            it = d.insert (d.begin() + pos, one_pass<T> (src.data()), one_pass<T> (src.data() + count));
+            assert (it == d.begin() + pos);
+            ref.insert (ref.begin() + pos, src.begin(), src.end());
+        }
+        same (d, ref);
+        d.erase (d.begin() + ref.size() / 3, d.begin() + ref.size() / 2);
+        ref.erase (ref.begin() + ref.size() / 3, ref.begin() + ref.size() / 2);
+        same (d, ref);
+    }
+}
+
+int main () {
+    check<int, 64> ();
+    check<int, 4096> ();
+    check<std::string, 128> ();
+
+    //two integers are a count and a value
+    tinySTL::deque<int> d (10, 1);
+    d.insert (d.begin() + 5, 3, 7);
+    assert (d.size() == 13 && d[4] == 1 && d[5] == 7 && d[7] == 7 && d[8] == 1);
+
+    //a large middle insert moves only the shorter side
+    tinySTL::deque<int> big;
+    for (int i = 0; i < 1000000; ++i)
+        big.push_back (i);
+    std::vector<int> block (5000, -1);
+    big.insert (big.begin() + 600000, block.data(), block.data() + block.size());
+    assert (big.size() == 1005000 && big[599999] == 599999 && big[600000] == -1
+            && big[604999] == -1 && big[605000] == 600000 && big.back() == 999999);
+    big.erase (big.begin() + 600000, big.begin() + 605000);
+    for (int i = 0; i < 1000000; i += 997)
+        assert (big[i] == i);
+
+    std::cout << "deque insert ok" << std::endl;
+    return 0;
+}
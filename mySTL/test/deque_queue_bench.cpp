@@ -0,0 +1,41 @@
+#include "../include/st_deque.h"
+#include <chrono>
+#include <stdio.h>
+
+using namespace std;
+
+//deque<int> as a FIFO holding a fixed number of elements: ns per
+//push_back plus pop_front, and allocator calls per million of them
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct counting_alloc : public tinySTL::SimpleAlloc {
+    static long calls;
+    static pointer allocate(size_type nbytes) { ++calls; return SimpleAlloc::allocate(nbytes); }
+    static void deallocate(pointer p) { ++calls; SimpleAlloc::deallocate(p); }
+};
+long counting_alloc::calls = 0;
+
+enum {OPS = 1 << 24};
+
+int main() {
+    long check = 0;
+    printf("%10s %10s %16s\n", "length", "ns/op", "calls/M ops");
+    for (int length = 16; length <= 1 << 20; length *= 16) {
+        tinySTL::deque<int, counting_alloc> q;
+        for (int i = 0; i < length; ++i)
+            q.push_back(i);
+        counting_alloc::calls = 0;
+        double t = now();
+        for (int i = 0; i < OPS; ++i) {
+            q.push_back(i);
+            check += q.front();
+            q.pop_front();
+        }
+        double ns = (now() - t) / OPS * 1e9;
+        printf("%10d %10.2f %16.1f\n", length, ns, counting_alloc::calls * 1e6 / OPS);
+    }
+    return check == 0;
+}
@@ -0,0 +1,120 @@
+#include "../include/st_deque.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+struct counting_alloc : public tinySTL::SimpleAlloc {
+    static int allocs;
+    static int frees;
+    static pointer allocate (size_type nbytes) { ++allocs; return SimpleAlloc::allocate(nbytes); }
+    static void deallocate (pointer p) { ++frees; SimpleAlloc::deallocate(p); }
+};
+int counting_alloc::allocs = 0;
+int counting_alloc::frees = 0;
+
+//small buffers so the window slides across many of them
+typedef tinySTL::deque<int, counting_alloc, 64> queue;
+
+//a warm queue reuses its buffers and its map whichever way it runs
+void steady_state () {
+    queue q;
+    for (int i = 0; i < 1000; ++i)
+        q.push_back (i);
+    for (int i = 0; i < 100000; ++i) {
+        q.push_back (i);
+        q.pop_front ();
+    }
+    int allocs = counting_alloc::allocs, frees = counting_alloc::frees;
+    for (int i = 0; i < 1000000; ++i) {
+        q.push_back (i);
+        assert (q.front() == (i < 1000 ? 99000 + i : i - 1000));
+        q.pop_front ();
+    }
+    for (int i = 0; i < 1000000; ++i) {
+        q.push_front (i);
+        q.pop_back ();
+    }
+    assert (counting_alloc::allocs == allocs && counting_alloc::frees == frees);
+    assert (q.size() == 1000);
+}
+
+//erase and clear hand their buffers to the spares, shrink_to_fit frees them
+void spares () {
+    {
+        queue q;
+        for (int i = 0; i < 200; ++i)
+            q.push_back (i);
+        int allocs = counting_alloc::allocs, frees = counting_alloc::frees;
+        //a buffer from each end
+        q.erase (q.begin(), q.begin() + 16);
+        q.erase (q.end() - 16, q.end());
+        for (int i = 0; i < 16; ++i) {
+            q.push_back (i);
+            q.push_front (i);
+        }
+        assert (counting_alloc::allocs == allocs && counting_alloc::frees == frees);
+        assert (q.size() == 200 && q.front() == 15 && q[16] == 16 && q.back() == 15);
+
+        q.clear ();
+        assert (counting_alloc::frees > frees);
+        frees = counting_alloc::frees;
+        q.shrink_to_fit ();
+        assert (counting_alloc::frees == frees + 2);
+        q.shrink_to_fit ();
+        assert (counting_alloc::frees == frees + 2);
+        q.push_back (1);
+        assert (q.size() == 1 && q[0] == 1);
+    }
+    assert (counting_alloc::allocs == counting_alloc::frees);
+
+    //spares travel with the buffers they came from
+    {
+        queue a, b;
+        for (int i = 0; i < 100; ++i)
+            a.push_back (i);
+        a.erase (a.begin(), a.begin() + 50);
+        a.swap (b);
+        b.push_front (7);
+        assert (a.empty() && b.size() == 51 && b.front() == 7 && b.back() == 99);
+        queue c (std::move (b));
+        assert (c.size() == 51);
+    }
+    assert (counting_alloc::allocs == counting_alloc::frees);
+
+    //both sides holding spares, swapped and moved: each buffer is reused
+    //or freed exactly once
+    {
+        queue a, b;
+        for (int i = 0; i < 100; ++i) {
+            a.push_back (i);
+            b.push_back (-i);
+        }
+        a.erase (a.begin(), a.begin() + 32);
+        b.erase (b.end() - 16, b.end());
+        a.swap (b);
+        int allocs = counting_alloc::allocs;
+        for (int i = 0; i < 16; ++i) {
+            a.push_back (i);
+            b.push_front (i);
+        }
+        assert (counting_alloc::allocs == allocs);
+        queue c (std::move (a));
+        c.swap (b);
+        b = std::move (c);
+        assert (a.empty() && c.empty() && b.size() == 84 && b.front() == 15 && b.back() == 99);
+    }
+    assert (counting_alloc::allocs == counting_alloc::frees);
+}
+
+int main () {
+    steady_state ();
+    spares ();
+    tinySTL::deque<std::string> strs;
+    for (int i = 0; i < 10000; ++i) {
+        strs.push_back (std::string (40, 'a' + i % 26));
+        if (i % 3) strs.pop_front ();
+    }
+    assert (strs.size() == 3334 && strs.back() == std::string (40, 'a' + 9999 % 26));
+    std::cout << "deque queue ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include "../include/st_deque.h"
+#include "../include/st_vector.h"
+#include "test_helpers.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <assert.h>
+
+//a 40 byte element fills a 256 byte buffer with 4, so short ranges cross buffers
+struct wide {
+    long a, b, c, d, e;
+};
+bool operator== (const wide& x, const wide& y) { return x.a == y.a && x.e == y.e; }
+bool operator!= (const wide& x, const wide& y) { return !(x == y); }
+
+wide make (int i, wide*) { wide w = {i, 0, 0, 0, -i}; return w; }
+
+//every algorithm against a std::vector doing the same work element by element
+template <class T, size_t Bytes>
+void check () {
+    T* tag = 0;
+    for (int round = 0; round < 300; ++round) {
+        tinySTL::deque<T, tinySTL::SimpleAlloc, Bytes> d;
+        std::vector<T> ref;
+        int n = rand () % 200;
+        for (int i = 0; i < n; ++i) {
+            if (rand () % 2) {
+                d.push_back (make (i, tag));
+                ref.push_back (make (i, tag));
+            } else {
+                d.push_front (make (i, tag));
+                ref.insert (ref.begin(), make (i, tag));
+            }
+        }
+        same (d, ref);
+        if (n == 0) continue;
+
+        //copy out of, into and within a deque
+        size_t a = rand () % n, b = a + rand () % (n - a + 1);
+        tinySTL::vector<T> v (b - a, make (0, tag));
+        assert (tinySTL::copy (d.begin() + a, d.begin() + b, v.begin()) == v.end());
+        for (size_t i = a; i < b; ++i)
+            assert (v[i - a] == ref[i]);
+        assert (tinySTL::equal (v.begin(), v.end(), d.begin() + a));
+        assert (tinySTL::equal (d.begin() + a, d.begin() + b, v.begin()));
+        tinySTL::deque<T, tinySTL::SimpleAlloc, Bytes> e (d);
+        assert (e == d);
+        if (b > a) {
+            e[b - 1] = make (n + 1, tag);
+            assert (!tinySTL::equal (e.begin() + a, e.begin() + b, d.begin() + a));
+            assert (!tinySTL::equal (v.begin(), v.end(), e.begin() + a));
+        }
+
+        size_t to = rand () % (n - (b - a) + 1);
+        tinySTL::copy (v.begin(), v.end(), d.begin() + to);
+        tinySTL::fill (d.begin() + to, d.begin() + to + (b - a) / 2, make (7, tag));
+        tinySTL::fill_n (d.begin() + to + (b - a) / 2, (b - a) - (b - a) / 2, make (9, tag));
+        for (size_t i = 0; i < b - a; ++i)
+            ref[to + i] = make (i < (b - a) / 2 ? 7 : 9, tag);
+        same (d, ref);
+
+        //shifts in both directions, as erase and insert do them
+        std::copy (ref.begin() + a, ref.begin() + b, ref.begin() + a / 2);
+        tinySTL::copy (d.begin() + a, d.begin() + b, d.begin() + a / 2);
+        same (d, ref);
+        if (b < (size_t)n) {
+            size_t shift = rand () % (n - b) + 1;
+            std::copy_backward (ref.begin() + a, ref.begin() + b, ref.begin() + b + shift);
+            assert (tinySTL::backward_copy (d.begin() + a, d.begin() + b, d.begin() + b + shift - 1)
+                    == d.begin() + a + shift - 1);
+            same (d, ref);
+        }
+
+        d.erase (d.begin() + a, d.begin() + b);
+        ref.erase (ref.begin() + a, ref.begin() + b);
+        same (d, ref);
+        if (!ref.empty()) {
+            size_t pos = rand () % ref.size();
+            d.insert (d.begin() + pos, make (3, tag));
+            ref.insert (ref.begin() + pos, make (3, tag));
+            d.erase (d.begin() + pos / 2);
+            ref.erase (ref.begin() + pos / 2);
+            same (d, ref);
+        }
+    }
+}
+
+int main () {
+    //buffers hold the largest power of two of elements that fits the budget
+    assert ((tinySTL::deque<int>::iterator::buffer_size() == 1024));
+    assert ((tinySTL::deque<wide, tinySTL::SimpleAlloc, 256>::iterator::buffer_size() == 4));
+    assert ((tinySTL::deque<wide, tinySTL::SimpleAlloc, 8>::iterator::buffer_size() == 1));
+    assert ((tinySTL::deque<char, tinySTL::SimpleAlloc, 1000>::iterator::buffer_size() == 512));
+
+    check<int, 64> ();
+    check<int, 4096> ();
+    check<wide, 256> ();
+    check<wide, 8> ();
+    check<std::string, 128> ();
+    std::cout << "deque segments ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include "../include/st_vector.h"
+#include <iostream>
+#include <assert.h>
+
+//capacities seen while pushing n ints with the given policy
+template <class Growth>
+size_t last_capacity (size_t n, size_t* steps) {
+    tinySTL::vector<int, tinySTL::SimpleAlloc, Growth> vec;
+    size_t cap = 0;
+    *steps = 0;
+    for (size_t i = 0; i < n; ++i) {
+        vec.push_back ((int)i);
+        assert (vec.capacity() >= vec.size());
+        if (vec.capacity() != cap) {
+            cap = vec.capacity();
+            ++*steps;
+        }
+    }
+    for (size_t i = 0; i < n; ++i)
+        assert (vec[i] == (int)i);
+    return cap;
+}
+
+int main () {
+    size_t steps;
+    assert (last_capacity<tinySTL::grow_double> (1000, &steps) == 1024 && steps == 11);
+    assert (last_capacity<tinySTL::grow_one_and_half> (1000, &steps) >= 1000 && steps > 11);
+
+    //blocks of the page-aware policy end on a size class or a page
+    tinySTL::vector<int, tinySTL::SimpleAlloc, tinySTL::grow_page_aware> vec;
+    for (int i = 0; i < 100000; ++i) {
+        vec.push_back (i);
+        size_t bytes = vec.capacity() * sizeof(int);
+        assert (tinySTL::grow_page_aware::round_bytes (bytes) == bytes);
+    }
+    assert (tinySTL::grow_page_aware::round_bytes (1) == 16);
+    assert (tinySTL::grow_page_aware::round_bytes (129) == 160);
+    assert (tinySTL::grow_page_aware::round_bytes (3000) == 3072);
+    assert (tinySTL::grow_page_aware::round_bytes (4097) == 8192);
+
+    //range insert grows through the policy too
+    int a[300];
+    for (int i = 0; i < 300; ++i) a[i] = i;
+    tinySTL::vector<int, tinySTL::SimpleAlloc, tinySTL::grow_one_and_half> half;
+    half.insert (half.end(), a, a + 300);
+    half.insert (half.begin(), a, a + 10);
+    assert (half.size() == 310 && half.capacity() == 450 && half[10] == 0 && half[309] == 299);
+    std::cout << "growth policy ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include "../include/st_rb_tree.h"
+#include "../include/st_chunk_provider.h"
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+//rb_tree lookups over a large tree whose nodes come from malloc regions
+//or from 2MiB mmap regions with transparent huge pages requested.
+//Every backend runs in its own process so the pools start empty.
+
+typedef tinySTL::rb_tree<unsigned, unsigned, tinySTL::identity<unsigned>, tinySTL::less<unsigned> > tree;
+
+enum {LOOKUPS = 5000000};
+
+//kB of anonymous memory backed by huge pages, -1 if unknown
+static long anon_huge_kb() {
+    FILE* f = fopen("/proc/self/smaps_rollup", "r");
+    if (!f) return -1;
+    char line[256];
+    long kb = -1;
+    while (fgets(line, sizeof(line), f))
+        if (sscanf(line, "AnonHugePages: %ld kB", &kb) == 1) break;
+    fclose(f);
+    return kb;
+}
+
+static void run(const tinySTL::chunk_provider& provider, size_t n) {
+    tinySTL::set_node_pool_chunk_provider(provider);
+    vector<unsigned> keys(n);
+    for (size_t i = 0; i < n; ++i) keys[i] = (unsigned)(i * 2654435761u);
+    mt19937 rng(1);
+    shuffle(keys.begin(), keys.end(), rng);
+
+    tree t;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        t.insert_unique(keys[i]);
+    double build = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    unsigned long found = 0;
+    begin = chrono::steady_clock::now();
+    for (int i = 0; i < LOOKUPS; ++i)
+        found += t.find(keys[rng() % n]) != t.end();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+
+    printf("%8s %10zu nodes: build %6.2f s, lookup %7.1f ns, huge pages %ld kB%s\n",
+           provider.name, n, build, sec / LOOKUPS * 1e9, anon_huge_kb(),
+           found == LOOKUPS ? "" : " (lookup failed)");
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 10000000;
+    const tinySTL::chunk_provider* providers[] = {&tinySTL::malloc_chunks(), &tinySTL::mmap_chunks()};
+    for (size_t i = 0; i < sizeof(providers) / sizeof(providers[0]); ++i) {
+        fflush(stdout);
+        pid_t pid = fork();
+        if (pid == 0) {
+            run(*providers[i], n);
+            return 0;
+        }
+        waitpid(pid, 0, 0);
+    }
+    return 0;
+}
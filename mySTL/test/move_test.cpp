@@ -0,0 +1,132 @@
+#include "../include/st_vector.h"
+#include "../include/st_list.h"
+#include "../include/st_deque.h"
+#include "../include/st_rb_tree.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+//counts how often values are copied and moved
+struct tracked {
+    static int copies;
+    static int moves;
+    int value;
+
+    tracked (int v = 0) : value(v) { }
+    tracked (int a, int b) : value(a * 100 + b) { }
+    tracked (const tracked& x) : value(x.value) { ++copies; }
+    tracked (tracked&& x) : value(x.value) { x.value = -1; ++moves; }
+    tracked& operator= (const tracked& x) { value = x.value; ++copies; return *this; }
+    tracked& operator= (tracked&& x) { value = x.value; x.value = -1; ++moves; return *this; }
+    bool operator< (const tracked& x) const { return value < x.value; }
+
+    static void reset () { copies = 0; moves = 0; }
+};
+int tracked::copies = 0;
+int tracked::moves = 0;
+
+typedef tinySTL::rb_tree<tracked, tracked, tinySTL::identity<tracked>, tinySTL::less<tracked> > tracked_tree;
+typedef tinySTL::rb_tree<std::string, std::string, tinySTL::identity<std::string>, tinySTL::less<std::string> > string_tree;
+
+//growing and shifting a vector moves the elements, never copies them
+void vector_test () {
+    tinySTL::vector<tracked> vec;
+    tracked::reset ();
+    for (int i = 0; i < 1000; ++i)
+        vec.emplace_back (i);
+    vec.emplace (vec.begin(), 3, 4);
+    vec.insert (vec.begin() + 10, tracked(7));
+    vec.erase (vec.begin() + 5);
+    assert (tracked::copies == 0);
+    assert (vec.size() == 1001 && vec[0].value == 304 && vec[9].value == 7);
+
+    tinySTL::vector<tracked> other (std::move(vec));
+    assert (vec.size() == 0 && other.size() == 1001 && tracked::copies == 0);
+    vec = std::move(other);
+    assert (other.size() == 0 && vec.size() == 1001 && tracked::copies == 0);
+
+    tinySTL::vector<std::string> strs;
+    for (int i = 0; i < 100; ++i)
+        strs.push_back (std::string(40, 'a' + i % 26));
+    strs.insert (strs.begin() + 50, std::string("middle"));
+    strs.emplace (strs.begin(), 3, 'z');
+    strs.push_back (strs[0]);
+    assert (strs.size() == 103 && strs[0] == "zzz" && strs[51] == "middle" && strs[102] == "zzz");
+    tinySTL::vector<std::string> copied;
+    copied = strs;
+    assert (copied.size() == 103 && copied[51] == "middle");
+}
+
+void list_test () {
+    tinySTL::list<tracked> lst;
+    tracked::reset ();
+    for (int i = 0; i < 100; ++i) {
+        lst.emplace_back (i);
+        lst.emplace_front (1, i);
+        lst.push_back (tracked(i));
+    }
+    lst.emplace (lst.begin(), 5, 5);
+    assert (tracked::copies == 0 && lst.size() == 301 && lst.front().value == 505);
+
+    tinySTL::list<tracked> other (std::move(lst));
+    assert (lst.empty() && other.size() == 301);
+    lst = std::move(other);
+    assert (other.empty() && lst.size() == 301 && tracked::copies == 0);
+}
+
+void deque_test () {
+    tinySTL::deque<tracked> deq;
+    tracked::reset ();
+    for (int i = 0; i < 1000; ++i) {
+        deq.emplace_back (i);
+        deq.emplace_front (-i);
+    }
+    deq.emplace (deq.begin() + 100, 2, 3);
+    deq.insert (deq.begin() + 1500, tracked(9));
+    deq.erase (deq.begin() + 10);
+    assert (tracked::copies == 0 && deq.size() == 2001);
+    assert (deq[99].value == 203 && deq[1499].value == 9);
+
+    tinySTL::deque<tracked> other (std::move(deq));
+    assert (deq.empty() && other.size() == 2001);
+    deq = std::move(other);
+    assert (other.empty() && deq.size() == 2001 && tracked::copies == 0);
+
+    tinySTL::deque<std::string> strs;
+    for (int i = 0; i < 600; ++i)
+        strs.push_back (std::string(30, 'a' + i % 26));
+    strs.insert (strs.begin() + 17, std::string("front half"));
+    strs.insert (strs.begin() + 500, std::string("back half"));
+    assert (strs[17] == "front half" && strs[500] == "back half" && strs.size() == 602);
+}
+
+void rb_tree_test () {
+    tracked_tree tree;
+    tracked::reset ();
+    for (int i = 0; i < 200; ++i) {
+        assert (tree.emplace_unique (i).second);
+        tree.insert_unique (tracked(i));
+        tree.emplace_equal (i + 1000);
+    }
+    assert (tracked::copies == 0 && tree.size() == 400);
+
+    tracked_tree other (std::move(tree));
+    assert (tree.empty() && other.size() == 400);
+    tree = std::move(other);
+    assert (other.empty() && tree.size() == 400 && tracked::copies == 0);
+
+    string_tree strs;
+    strs.insert_unique (std::string("b"));
+    strs.emplace_unique (3, 'a');
+    assert (!strs.emplace_unique ("b").second);
+    assert (*strs.begin() == "aaa" && strs.size() == 2);
+}
+
+int main () {
+    vector_test ();
+    list_test ();
+    deque_test ();
+    rb_tree_test ();
+    std::cout << "move ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "../include/st_list.h"
+#include "../include/st_rb_tree.h"
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//list and rb_tree node churn with the pooled default nodes against
+//plain malloc nodes
+
+//Alloc that always goes to malloc, so nodes bypass the pool
+struct malloc_alloc {
+    static void* allocate(size_t n) { return malloc(n); }
+    static void* reallocate(void* p, size_t n) { return realloc(p, n); }
+    static void deallocate(void* p) { free(p); }
+};
+
+enum {LIST_LEN = 1000, LIST_ROUNDS = 2000, BOOK_SIZE = 100000, BOOK_OPS = 2000000};
+
+template <class Alloc>
+static void list_worker() {
+    tinySTL::list<int, Alloc> l;
+    for (int r = 0; r < LIST_ROUNDS; ++r) {
+        for (int i = 0; i < LIST_LEN; ++i)
+            l.push_back(i);
+        for (int i = 0; i < LIST_LEN; ++i)
+            l.pop_front();
+    }
+}
+
+template <class Alloc>
+static double list_run(int nthreads) {
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    vector<thread> threads;
+    for (int i = 0; i < nthreads; ++i)
+        threads.push_back(thread(list_worker<Alloc>));
+    for (int i = 0; i < nthreads; ++i)
+        threads[i].join();
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    return 2.0 * LIST_LEN * LIST_ROUNDS * nthreads / sec / 1e6;
+}
+
+//order-book style: a tree of live price levels, each step removes one
+//level and adds another
+template <class Alloc>
+static double book_run() {
+    typedef tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int>, Alloc> book;
+    book levels;
+    vector<int> live;
+    srand(1);
+    while (live.size() < BOOK_SIZE) {
+        int k = rand();
+        if (levels.insert_unique(k).second)
+            live.push_back(k);
+    }
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for (int i = 0; i < BOOK_OPS; ++i) {
+        size_t slot = rand() % live.size();
+        levels.erase(levels.find(live[slot]));
+        int k;
+        do {
+            k = rand();
+        } while (!levels.insert_unique(k).second);
+        live[slot] = k;
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    return 2.0 * BOOK_OPS / sec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)thread::hardware_concurrency();
+    if (max_threads < 1) max_threads = 1;
+
+    printf("%8s %16s %16s\n", "threads", "list pool", "list malloc");
+    for (int t = 1; t <= max_threads; t *= 2) {
+        double pool = list_run<tinySTL::SimpleAlloc>(t);
+        double sys = list_run<malloc_alloc>(t);
+        printf("%8d %11.1f Mop/s %11.1f Mop/s\n", t, pool, sys);
+    }
+
+    double pool = book_run<tinySTL::SimpleAlloc>();
+    double sys = book_run<malloc_alloc>();
+    printf("rb_tree order book: pool %.2f Mop/s, malloc %.2f Mop/s\n", pool, sys);
+    return 0;
+}
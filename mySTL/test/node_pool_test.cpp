@@ -0,0 +1,72 @@
+#include "../include/st_node_pool.h"
+#include "../include/st_ring_buffer.h"
+#include "../include/st_list.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <assert.h>
+
+//one thread allocates, another frees: the freed objects come back to
+//the allocating thread through the depot instead of piling up
+void cross_thread () {
+    typedef tinySTL::node_pool<48, 8> pool;
+    enum {ITEMS = 2000000};
+    tinySTL::ring_buffer<void*> handoff (1024);
+    std::thread consumer ([&] {
+        void* p;
+        for (int got = 0; got < ITEMS; ) {
+            if (handoff.pop (p)) {
+                pool::deallocate (p);
+                ++got;
+            } else
+                std::this_thread::yield ();
+        }
+    });
+    size_t peak = 0;
+    for (int i = 0; i < ITEMS; ++i) {
+        void* p = pool::allocate ();
+        *(int*)p = i;
+        while (!handoff.push (p))
+            std::this_thread::yield ();
+        if (i % 4096 == 0) {
+            size_t heap = pool::heap_size ();
+            peak = heap > peak ? heap : peak;
+        }
+    }
+    consumer.join ();
+    //what is in flight: the handoff, two thread caches and the depot
+    assert (peak <= 1024 * 1024);
+}
+
+//a large free goes back to the provider without an explicit trim
+void release () {
+    typedef tinySTL::node_pool<24, 8> pool;
+    std::vector<void*> objs;
+    for (int i = 0; i < 1000000; ++i)
+        objs.push_back (pool::allocate ());
+    size_t full = pool::heap_size ();
+    assert (full >= 24 * objs.size());
+    for (size_t i = 0; i < objs.size(); ++i)
+        pool::deallocate (objs[i]);
+    assert (pool::heap_size () < full / 4);
+    pool::trim ();
+    assert (pool::heap_size () == 0);
+    void* p = pool::allocate ();
+    pool::deallocate (p);
+    assert (pool::heap_size () > 0);
+}
+
+int main () {
+    cross_thread ();
+    release ();
+    //a list's nodes keep working across trims
+    tinySTL::list<int> l;
+    for (int i = 0; i < 100000; ++i)
+        l.push_back (i);
+    l.clear ();
+    for (int i = 0; i < 10; ++i)
+        l.push_back (i);
+    assert (l.size() == 10 && l.back() == 9);
+    std::cout << "node_pool ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include "../include/st_vector.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+//owns a heap value but never points into itself, so it is relocatable
+struct handle {
+    static int destroyed;
+    int* p;
+
+    handle (int v = 0) : p(new int(v)) { }
+    handle (const handle& x) : p(new int(*x.p)) { }
+    handle (handle&& x) : p(x.p) { x.p = 0; }
+    handle& operator= (const handle& x) { *p = *x.p; return *this; }
+    handle& operator= (handle&& x) { tinySTL::swap(p, x.p); return *this; }
+    ~handle () { ++destroyed; delete p; }
+};
+int handle::destroyed = 0;
+
+namespace tinySTL {
+    template<> struct is_trivially_relocatable<handle> { typedef _true_type type; };
+}
+
+//SimpleAlloc that counts how the vector asks for storage
+struct counting_alloc : public tinySTL::SimpleAlloc {
+    static int allocs;
+    static int reallocs;
+    static pointer allocate (size_type nbytes) { ++allocs; return SimpleAlloc::allocate(nbytes); }
+    static pointer reallocate (pointer p, size_type nbytes) { ++reallocs; return SimpleAlloc::reallocate(p, nbytes); }
+};
+int counting_alloc::allocs = 0;
+int counting_alloc::reallocs = 0;
+
+//growth of relocatable elements goes through reallocate, no destructor runs
+void relocatable_growth () {
+    {
+        tinySTL::vector<handle, counting_alloc> vec;
+        for (int i = 0; i < 1000; ++i)
+            vec.emplace_back (i);
+        for (int i = 0; i < 10; ++i)
+            vec.insert (vec.begin() + i * 50, handle(-i));
+        vec.push_back (vec[3]);
+        vec.reserve (5000);
+        //only temporaries died: one per growth, two per insert
+        assert (handle::destroyed == 11 + 20);
+        assert (counting_alloc::allocs == 0 && counting_alloc::reallocs > 0);
+        assert (vec.size() == 1011 && *vec[0].p == 0 && *vec[50].p == -1 && *vec[1010].p == 2);
+        vec.resize (1020, vec[0]);
+        vec.shrink_to_fit ();
+        assert (vec.capacity() == 1020 && *vec[1019].p == 0 && *vec[51].p == 49);
+        handle::destroyed = 0;
+    }
+    assert (handle::destroyed == 1020);
+
+    tinySTL::vector<int, counting_alloc> ints;
+    counting_alloc::reallocs = 0;
+    for (int i = 0; i < 100000; ++i)
+        ints.push_back (i);
+    assert (counting_alloc::allocs == 0 && counting_alloc::reallocs == 18);
+    for (int i = 0; i < 100000; ++i)
+        assert (ints[i] == i);
+}
+
+//other types still move element by element
+void plain_growth () {
+    tinySTL::vector<std::string, counting_alloc> strs;
+    counting_alloc::reallocs = 0;
+    for (int i = 0; i < 100; ++i)
+        strs.push_back (std::string(50, 'a' + i % 26));
+    strs.insert (strs.begin() + 1, strs[0]);
+    strs.shrink_to_fit ();
+    assert (counting_alloc::reallocs == 0 && counting_alloc::allocs > 0);
+    assert (strs.size() == 101 && strs[1] == strs[0] && strs[100] == std::string(50, 'a' + 99 % 26));
+}
+
+int main () {
+    relocatable_growth ();
+    plain_growth ();
+    std::cout << "relocate ok" << std::endl;
+    return 0;
+}
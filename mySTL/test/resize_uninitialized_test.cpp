@@ -0,0 +1,49 @@
+#include "../include/st_vector.h"
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <assert.h>
+
+struct counted {
+    static int built;
+    int value;
+    counted () : value(7) { ++built; }
+};
+int counted::built = 0;
+
+int main () {
+    //POD buffers are sized without touching the new bytes
+    tinySTL::vector<char> bytes;
+    bytes.resize_uninitialized (1 << 20);
+    assert (bytes.size() == (1 << 20) && bytes.capacity() == (1 << 20));
+    memset (bytes.data(), 'x', bytes.size());
+    bytes.resize_uninitialized (10);
+    assert (bytes.size() == 10 && bytes[9] == 'x');
+
+    tinySTL::vector<float> floats;
+    for (int round = 0; round < 100; ++round) {
+        float* p = floats.append_uninitialized (1000);
+        for (int i = 0; i < 1000; ++i)
+            p[i] = (float)(round * 1000 + i);
+    }
+    assert (floats.size() == 100000 && floats.capacity() < 200000);
+    for (size_t i = 0; i < floats.size(); ++i)
+        assert (floats[i] == (float)i);
+
+    //other types are default constructed
+    tinySTL::vector<counted> objs;
+    counted* c = objs.append_uninitialized (5);
+    assert (counted::built == 5 && c == objs.data() && objs[4].value == 7);
+    objs.resize_uninitialized (3);
+    objs.resize_uninitialized (9);
+    assert (counted::built == 11 && objs[8].value == 7);
+
+    tinySTL::vector<std::string> strs;
+    strs.resize_uninitialized (4);
+    std::string* s = strs.append_uninitialized (2);
+    s[1] = "last";
+    assert (strs.size() == 6 && strs[0].empty() && strs[5] == "last");
+
+    std::cout << "resize_uninitialized ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "../include/st_ring_buffer.h"
+#include "../include/st_deque.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <stdio.h>
+
+using namespace std;
+
+//one producer hands ints to one consumer through a queue of 1024 slots.
+//Throughput in million items per second, one item at a time and in
+//batches of 32; latency in ns per round trip of one item bounced between
+//two threads through a pair of queues. The ring buffers against a
+//tinySTL::deque behind a mutex. Waiting threads yield, so the numbers
+//stay meaningful on a single core.
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum {ITEMS = 1 << 22, TRIPS = 1 << 16, BATCH = 32, CAP = 1024};
+
+template <class Concurrency>
+struct ring_queue {
+    tinySTL::ring_buffer<int, Concurrency> r;
+    ring_queue() : r(CAP) { }
+    bool push(int x) { return r.push(x); }
+    bool pop(int& x) { return r.pop(x); }
+    size_t push_n(const int* p, size_t n) { return r.push_n(p, n); }
+    size_t pop_n(int* p, size_t n) { return r.pop_n(p, n); }
+};
+
+struct locked_queue {
+    mutex m;
+    tinySTL::deque<int> q;
+    bool push(int x) {
+        lock_guard<mutex> g(m);
+        if (q.size() == CAP) return false;
+        q.push_back(x);
+        return true;
+    }
+    bool pop(int& x) {
+        lock_guard<mutex> g(m);
+        if (q.empty()) return false;
+        x = q.front();
+        q.pop_front();
+        return true;
+    }
+    size_t push_n(const int* p, size_t n) {
+        lock_guard<mutex> g(m);
+        if (n > CAP - q.size()) n = CAP - q.size();
+        for (size_t i = 0; i < n; ++i)
+            q.push_back(p[i]);
+        return n;
+    }
+    size_t pop_n(int* p, size_t n) {
+        lock_guard<mutex> g(m);
+        if (n > q.size()) n = q.size();
+        for (size_t i = 0; i < n; ++i) {
+            p[i] = q.front();
+            q.pop_front();
+        }
+        return n;
+    }
+};
+
+static atomic<long> sink(0);
+
+template <class Queue>
+static double throughput(bool batched) {
+    Queue q;
+    double t = now();
+    thread producer([&] {
+        int buf[BATCH];
+        for (int next = 0; next < ITEMS; ) {
+            if (!batched) {
+                if (q.push(next)) ++next;
+                else this_thread::yield();
+                continue;
+            }
+            for (int i = 0; i < BATCH; ++i)
+                buf[i] = next + i;
+            size_t n = q.push_n(buf, BATCH);
+            if (!n) this_thread::yield();
+            next += n;
+        }
+    });
+    long sum = 0;
+    int buf[BATCH];
+    for (int got = 0; got < ITEMS; ) {
+        size_t n = batched ? q.pop_n(buf, BATCH) : q.pop(buf[0]);
+        if (!n) this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+            sum += buf[i];
+        got += n;
+    }
+    producer.join();
+    t = now() - t;
+    sink += sum;
+    return ITEMS / t / 1e6;
+}
+
+template <class Queue>
+static double latency() {
+    Queue there, back;
+    thread echo([&] {
+        int x;
+        for (int i = 0; i < TRIPS; ++i) {
+            while (!there.pop(x)) this_thread::yield();
+            while (!back.push(x)) this_thread::yield();
+        }
+    });
+    double t = now();
+    int x;
+    for (int i = 0; i < TRIPS; ++i) {
+        there.push(i);
+        while (!back.pop(x)) this_thread::yield();
+        sink += x;
+    }
+    t = now() - t;
+    echo.join();
+    return t / TRIPS * 1e9;
+}
+
+template <class Queue>
+static void row(const char* name) {
+    printf("%8s %12.1f %12.1f %12.0f\n", name, throughput<Queue>(false), throughput<Queue>(true),
+           latency<Queue>());
+}
+
+int main() {
+    printf("%8s %12s %12s %12s\n", "queue", "Mitems/s", "batch Mit/s", "trip ns");
+    row<ring_queue<tinySTL::spsc_tag> >("spsc");
+    row<ring_queue<tinySTL::mpmc_tag> >("mpmc");
+    row<locked_queue>("mutex");
+    return sink == 0;
+}
@@ -0,0 +1,142 @@
+#include "../include/st_ring_buffer.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <assert.h>
+
+typedef tinySTL::ring_buffer<int> spsc_ints;
+typedef tinySTL::ring_buffer<int, tinySTL::mpmc_tag> mpmc_ints;
+
+//spinning threads yield, the machine may have a single core
+
+//one thread: fifo order, full and empty, batches across the wrap
+template <class Ring>
+void sequential () {
+    Ring r (5);
+    int x;
+    assert (r.capacity() == 8 && r.empty() && !r.pop (x));
+    for (int i = 0; i < 8; ++i)
+        assert (r.push (i));
+    assert (!r.push (8) && r.size() == 8);
+    assert (r.pop (x) && x == 0 && r.pop (x) && x == 1);
+
+    int in[6] = {10, 11, 12, 13, 14, 15}, out[8];
+    assert (r.push_n (in, 6) == 2);
+    assert (r.pop_n (out, 3) == 3 && out[0] == 2 && out[2] == 4);
+    assert (r.push_n (in + 2, 4) == 3);
+    assert (r.pop_n (out, 8) == 8);
+    int expect[8] = {5, 6, 7, 10, 11, 12, 13, 14};
+    for (int i = 0; i < 8; ++i)
+        assert (out[i] == expect[i]);
+    assert (r.empty() && r.pop_n (out, 8) == 0 && r.push_n (in, 0) == 0);
+}
+
+//elements left behind are destroyed with the buffer
+template <class Ring>
+void strings () {
+    Ring r (4);
+    std::string s[3] = {std::string (40, 'a'), std::string (40, 'b'), std::string (40, 'c')};
+    assert (r.push (s[0]) && r.emplace (40, 'b') && r.push_n (s + 2, 1) == 1);
+    std::string x;
+    assert (r.pop (x) && x == s[0]);
+    std::string out[2];
+    assert (r.pop_n (out, 2) == 2 && out[0] == s[1] && out[1] == s[2]);
+    r.push (s[1]);
+    r.push (std::string (50, 'z'));
+}
+
+//a producer and a consumer, in order and in batches of varying size
+void spsc_stress () {
+    enum {ITEMS = 2000000};
+    spsc_ints r (64);
+    std::thread producer ([&] {
+        int buf[16];
+        for (int next = 0; next < ITEMS; ) {
+            if (next % 3 == 0) {
+                if (r.push (next)) ++next;
+                else std::this_thread::yield ();
+            } else {
+                int n = 0;
+                for (; n < 1 + next % 16 && next + n < ITEMS; ++n)
+                    buf[n] = next + n;
+                int pushed = r.push_n (buf, n);
+                if (!pushed) std::this_thread::yield ();
+                next += pushed;
+            }
+        }
+    });
+    int expect = 0, buf[32], x;
+    while (expect < ITEMS) {
+        if (expect % 5 == 0) {
+            if (r.pop (x)) assert (x == expect++);
+            else std::this_thread::yield ();
+        } else {
+            size_t n = r.pop_n (buf, 1 + expect % 32);
+            if (!n) std::this_thread::yield ();
+            for (size_t i = 0; i < n; ++i)
+                assert (buf[i] == expect++);
+        }
+    }
+    producer.join ();
+    assert (r.empty());
+}
+
+//several of each, every element comes out exactly once and each
+//producer's elements come out of one consumer in order
+void mpmc_stress (int producers, int consumers) {
+    enum {PER = 300000};
+    mpmc_ints r (128);
+    std::vector<std::atomic<int> > seen (producers * PER);
+    for (size_t i = 0; i < seen.size(); ++i)
+        seen[i].store (0);
+    std::atomic<int> consumed (0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+        threads.push_back (std::thread ([&, p] {
+            int buf[8];
+            for (int i = 0; i < PER; ) {
+                int n = 0;
+                for (; n < 1 + i % 8 && i + n < PER; ++n)
+                    buf[n] = p * PER + i + n;
+                int pushed = r.push_n (buf, n);
+                if (!pushed) std::this_thread::yield ();
+                i += pushed;
+            }
+        }));
+    for (int c = 0; c < consumers; ++c)
+        threads.push_back (std::thread ([&] {
+            std::vector<int> last (producers, -1);
+            int buf[8];
+            while (consumed.load () < producers * PER) {
+                size_t n = r.pop_n (buf, 8);
+                if (!n) std::this_thread::yield ();
+                for (size_t i = 0; i < n; ++i) {
+                    int p = buf[i] / PER;
+                    assert (buf[i] > last[p]);
+                    last[p] = buf[i];
+                    seen[buf[i]].fetch_add (1);
+                }
+                consumed += n;
+            }
+        }));
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join ();
+    for (size_t i = 0; i < seen.size(); ++i)
+        assert (seen[i].load() == 1);
+    assert (r.empty());
+}
+
+int main () {
+    sequential<spsc_ints> ();
+    sequential<mpmc_ints> ();
+    strings<tinySTL::ring_buffer<std::string> > ();
+    strings<tinySTL::ring_buffer<std::string, tinySTL::mpmc_tag> > ();
+    spsc_stress ();
+    mpmc_stress (1, 1);
+    mpmc_stress (3, 2);
+    mpmc_stress (2, 4);
+    std::cout << "ring buffer ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include "../include/st_vector.h"
+#include "../include/st_small_vector.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std;
+
+//per-message field lists: most messages carry fewer than 8 fields, a few
+//carry many. Each message builds its list, reads it and drops it.
+
+//SimpleAlloc that counts the blocks asked for
+struct counting_alloc : public tinySTL::SimpleAlloc {
+    static size_t calls;
+    static pointer allocate(size_type nbytes) { ++calls; return SimpleAlloc::allocate(nbytes); }
+    static pointer reallocate(pointer p, size_type nbytes) { ++calls; return SimpleAlloc::reallocate(p, nbytes); }
+};
+size_t counting_alloc::calls = 0;
+
+struct field {
+    int     tag;
+    int     length;
+    long    value;
+};
+
+enum {MESSAGES = 5000000, SIZES = 4096};
+
+static int sizes[SIZES];
+
+//90% of the messages have 1 to 7 fields, the rest 8 to 40
+static void make_sizes() {
+    srand(1);
+    for (int i = 0; i < SIZES; ++i)
+        sizes[i] = rand() % 10 ? 1 + rand() % 7 : 8 + rand() % 33;
+}
+
+template <class Fields>
+static void run(const char* name) {
+    counting_alloc::calls = 0;
+    long sum = 0;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for (int m = 0; m < MESSAGES; ++m) {
+        Fields fields;
+        int n = sizes[m % SIZES];
+        for (int i = 0; i < n; ++i) {
+            field f = {i, 8, (long)m * i};
+            fields.push_back(f);
+        }
+        for (size_t i = 0; i < fields.size(); ++i)
+            sum += fields[i].value;
+    }
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    printf("%-22s %10.3f %12.1f   (%ld)\n", name, (double)counting_alloc::calls / MESSAGES,
+           sec * 1e9 / MESSAGES, sum);
+}
+
+int main() {
+    make_sizes();
+    printf("%-22s %10s %12s\n", "container", "allocs/msg", "ns/msg");
+    run<tinySTL::vector<field, counting_alloc> >("vector");
+    run<tinySTL::small_vector<field, 4, counting_alloc> >("small_vector<4>");
+    run<tinySTL::small_vector<field, 8, counting_alloc> >("small_vector<8>");
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "../include/st_small_vector.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+typedef tinySTL::small_vector<int, 4> ints;
+typedef tinySTL::small_vector<std::string, 3> strings;
+
+bool same (const ints& v, const int* expect, size_t n) {
+    if (v.size() != n) return false;
+    for (size_t i = 0; i < n; ++i)
+        if (v[i] != expect[i]) return false;
+    return true;
+}
+
+//stays inline up to N elements and spills beyond
+void spill_test () {
+    ints v;
+    for (int i = 0; i < 4; ++i)
+        v.push_back (i);
+    assert (v.is_inline() && v.capacity() == 4);
+    v.push_back (4);
+    assert (!v.is_inline() && v.capacity() == 8);
+    v.erase (v.begin() + 1, v.begin() + 3);
+    v.shrink_to_fit ();
+    assert (v.is_inline());
+    int expect[] = {0, 3, 4};
+    assert (same (v, expect, 3));
+}
+
+void insert_test () {
+    ints v;
+    v.insert (v.end(), (size_t)2, 7);
+    v.insert (v.begin() + 1, 5);
+    int a[] = {1, 2, 3};
+    v.insert (v.begin(), a, a + 3);
+    int expect1[] = {1, 2, 3, 7, 5, 7};
+    assert (same (v, expect1, 6));
+    v.insert (v.begin() + 2, (size_t)3, v[0]);
+    int expect2[] = {1, 2, 1, 1, 1, 3, 7, 5, 7};
+    assert (same (v, expect2, 9));
+    v.emplace (v.begin() + 8, v[1]);
+    v.erase (v.begin());
+    int expect3[] = {2, 1, 1, 1, 3, 7, 5, 2, 7};
+    assert (same (v, expect3, 9));
+    v.assign ((size_t)2, v[4]);
+    int expect4[] = {3, 3};
+    assert (same (v, expect4, 2));
+    v.assign (a, a + 3);
+    v.resize (5, 9);
+    v.resize (4);
+    int expect5[] = {1, 2, 3, 9};
+    assert (same (v, expect5, 4));
+}
+
+void string_test () {
+    strings s;
+    for (int i = 0; i < 10; ++i)
+        s.push_back (std::string (20, 'a' + i));
+    s.insert (s.begin() + 3, s[9]);
+    s.erase (s.begin());
+    assert (s.size() == 10 && s[2] == std::string (20, 'j') && s[9] == std::string (20, 'j'));
+
+    strings small;
+    small.push_back ("x");
+    strings big (s);
+    assert (big == s);
+    small.swap (big);
+    assert (small.size() == 10 && big.size() == 1 && big.is_inline() && big[0] == "x");
+    strings moved (std::move (small));
+    assert (small.empty() && moved.size() == 10 && moved[9] == s[9]);
+    small = std::move (big);
+    assert (big.empty() && small.size() == 1 && small[0] == "x");
+    small = moved;
+    assert (small == moved && small.size() == 10);
+    moved.resize (2);
+    moved.shrink_to_fit ();
+    assert (moved.is_inline() && moved[1] == s[1]);
+    swap (moved, small);
+    assert (moved.size() == 10 && small.size() == 2 && small < moved);
+}
+
+int main () {
+    spill_test ();
+    insert_test ();
+    string_test ();
+    std::cout << "small_vector ok" << std::endl;
+    return 0;
+}
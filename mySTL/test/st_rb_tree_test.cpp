@@ -1,6 +1,79 @@
 #include "../include/st_rb_tree.h"
 #include "../include/st_algorithm.h"
 #include <iostream>
+#include <string>
+#include <assert.h>
+#include <stdlib.h>
+
+typedef tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int> > int_tree;
+
+//returns the black height, checks order and colors on the way
+int check (tinySTL::rb_tree_base* x, tinySTL::rb_tree_base* parent) {
+    if (x == 0) return 1;
+    assert (x->parent == parent);
+    if (x->color == tinySTL::_red) {
+        assert (x->left == 0 || x->left->color == tinySTL::_black);
+        assert (x->right == 0 || x->right->color == tinySTL::_black);
+    }
+    int l = check (x->left, x);
+    int r = check (x->right, x);
+    assert (l == r);
+    return l + (x->color == tinySTL::_black);
+}
+
+void erase_test () {
+    int_tree tree;
+    bool in[512] = {false};
+    srand (7);
+    for (int round = 0; round < 20000; ++round) {
+        int k = rand () % 512;
+        if (in[k]) {
+            int_tree::iterator it = tree.find (k);
+            assert (it != tree.end() && *it == k);
+            tree.erase (it);
+            in[k] = false;
+        } else {
+            assert (tree.find (k) == tree.end());
+            tree.insert_unique (k);
+            in[k] = true;
+        }
+        if (round % 64 == 0) {
+            tinySTL::rb_tree_base* header = tree.end().node;
+            assert (header->parent == 0 || header->parent->color == tinySTL::_black);
+            check (header->parent, header);
+        }
+    }
+    size_t n = 0;
+    int prev = -1;
+    for (int_tree::iterator it = tree.begin(); it != tree.end(); ++it, ++n) {
+        assert (*it > prev && in[*it]);
+        prev = *it;
+    }
+    assert (n == tree.size());
+    int_tree::iterator last = tree.end();
+    --last;
+    assert (*last == prev);
+
+    while (!tree.empty())
+        tree.erase (tree.begin());
+    assert (tree.begin() == tree.end());
+}
+
+//a key extractor returning by value: the tree compares the keys it returns
+struct first_char {
+    std::string operator() (const std::string& s) const { return s.substr (0, 1); }
+};
+
+void by_value_key_test () {
+    tinySTL::rb_tree<std::string, std::string, first_char, tinySTL::less<std::string> > tree;
+    const char* words[] = {"pear", "apple", "plum", "avocado", "fig", "peach"};
+    for (int i = 0; i < 6; ++i)
+        tree.insert_unique (std::string (words[i]));
+    assert (tree.size() == 3 && *tree.begin() == "apple");
+    assert (tree.find ("f") != tree.end() && tree.find ("k") == tree.end());
+    tree.erase (tree.find ("p"));
+    assert (tree.size() == 2);
+}
 
 int main () {
     tinySTL::rb_tree<int, int, tinySTL::identity<int>, tinySTL::less<int> > rbtree; 
@@ -9,6 +82,7 @@ int main () {
         rbtree.insert_equal(2*i);
     }
     
+    erase_test ();
+    by_value_key_test ();
     return 1;
 }
-
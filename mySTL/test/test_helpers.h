@@ -0,0 +1,20 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+#include <string>
+#include <assert.h>
+
+//Element values for the container tests. make(i, tag) gives the i-th
+//value of the type tag points to, tag is a null T* picking the overload;
+//strings are long enough to live on the heap.
+inline int make (int i, int*) { return i; }
+inline std::string make (int i, std::string*) { return std::string (20, 'x') + std::to_string (i); }
+
+//c holds the same elements as the std container ref, in the same order
+template <class Container, class Ref>
+void same (const Container& c, const Ref& ref) {
+    assert (c.size() == ref.size());
+    for (size_t i = 0; i < ref.size(); ++i)
+        assert (const_cast<Container&>(c)[i] == ref[i]);
+}
+
+#endif
@@ -0,0 +1,68 @@
+#include "../include/st_vector.h"
+#include <iostream>
+#include <string>
+#include <assert.h>
+
+struct point {
+    int     x;
+    float   y;
+};
+
+//copying has a side effect, kept on the slow path by hand
+struct logged {
+    int value;
+};
+namespace tinySTL {
+    template<> struct _type_traits<logged> {
+        typedef _true_type      has_trivial_default_constructor;
+        typedef _false_type     has_trivial_copy_constructor;
+        typedef _false_type     has_trivial_assignment_operator;
+        typedef _true_type      has_trivial_destructor;
+        typedef _false_type     is_POD_type;
+    };
+}
+
+struct with_default {
+    int value = 3;
+};
+
+template <class Tag>
+bool is_true (Tag) { return false; }
+bool is_true (tinySTL::_true_type) { return true; }
+
+int main () {
+    assert (is_true (tinySTL::_type_traits<int>::is_POD_type()));
+    assert (is_true (tinySTL::_type_traits<const char*>::is_POD_type()));
+    assert (is_true (tinySTL::_type_traits<point>::is_POD_type()));
+    assert (is_true (tinySTL::is_trivially_relocatable<point>::type()));
+    assert (!is_true (tinySTL::_type_traits<std::string>::is_POD_type()));
+    assert (!is_true (tinySTL::_type_traits<logged>::is_POD_type()));
+    assert (!is_true (tinySTL::_type_traits<with_default>::has_trivial_default_constructor()));
+    assert (is_true (tinySTL::_type_traits<with_default>::is_POD_type()));
+    assert (is_true (tinySTL::_type_traits<with_default>::has_trivial_destructor()));
+
+    //user structs now travel through the byte paths
+    tinySTL::vector<point> pts;
+    for (int i = 0; i < 1000; ++i) {
+        point p = {i, i * 0.5f};
+        pts.push_back (p);
+    }
+    tinySTL::vector<point> copy (pts);
+    point zero = {0, 0};
+    tinySTL::fill (copy.begin(), copy.begin() + 10, zero);
+    assert (copy[9].x == 0 && copy[10].x == 10 && copy[999].y == 499.5f);
+
+    tinySTL::vector<with_default> defs;
+    defs.resize_uninitialized (4);
+    assert (defs[3].value == 3);
+
+    tinySTL::vector<logged> logs;
+    for (int i = 0; i < 100; ++i) {
+        logged l = {i};
+        logs.push_back (l);
+    }
+    assert (logs[99].value == 99);
+
+    std::cout << "type traits ok" << std::endl;
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "../include/st_vector.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+//push_back throughput against peak memory for each growth policy.
+//Every run is its own process so that the peak RSS is its own.
+//int grows with reallocate; item is not relocatable and is moved into
+//a new block on every step, so old and new block live side by side.
+
+struct item {
+    long v;
+    item(long x) : v(x) { }
+    item(const item& x) : v(x.v) { }
+    item& operator=(const item&) = default;
+};
+
+//SimpleAlloc that counts the growth steps
+struct counting_alloc : public tinySTL::SimpleAlloc {
+    static size_t calls;
+    static pointer allocate(size_type nbytes) { ++calls; return SimpleAlloc::allocate(nbytes); }
+    static pointer reallocate(pointer p, size_type nbytes) { ++calls; return SimpleAlloc::reallocate(p, nbytes); }
+};
+size_t counting_alloc::calls = 0;
+
+static long peak_rss_mb() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024;
+}
+
+template <class T, class Growth>
+static void run(const char* policy, const char* type, size_t n) {
+    tinySTL::vector<T, counting_alloc, Growth> vec;
+    chrono::steady_clock::time_point begin = chrono::steady_clock::now();
+    for (size_t i = 0; i < n; ++i)
+        vec.push_back(T((long)i));
+    double sec = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+    printf("%-12s %-5s %10.1f %8zu %9.1f%% %10ld\n", policy, type, n / sec / 1e6, counting_alloc::calls,
+           100.0 * (vec.capacity() - vec.size()) / vec.size(), peak_rss_mb());
+}
+
+template <class Growth>
+static void policy(const char* name, size_t n) {
+    fflush(stdout);
+    if (fork() == 0) {
+        run<int, Growth>(name, "int", n);
+        exit(0);
+    }
+    wait(0);
+    fflush(stdout);
+    if (fork() == 0) {
+        run<item, Growth>(name, "item", n);
+        exit(0);
+    }
+    wait(0);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoul(argv[1], 0, 10) : 50000000;
+    printf("%-12s %-5s %10s %8s %10s %10s\n", "policy", "type", "Mop/s", "grows", "slack", "peak MB");
+    policy<tinySTL::grow_double>("2x", n);
+    policy<tinySTL::grow_one_and_half>("1.5x", n);
+    policy<tinySTL::grow_page_aware>("page-aware", n);
+    return 0;
+}
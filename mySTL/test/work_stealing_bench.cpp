@@ -0,0 +1,90 @@
+#include "../include/st_work_stealing_deque.h"
+#include "../include/st_deque.h"
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <stdio.h>
+
+using namespace std;
+
+//an owner pushes tasks in bursts of 64 and pops half of each burst back,
+//thieves steal the rest. Million tasks per second for the work-stealing
+//deque and for a tinySTL::deque behind a mutex, by number of thieves.
+
+static double now() {
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum {TASKS = 1 << 22, BURST = 64};
+
+struct ws_queue {
+    tinySTL::work_stealing_deque<int> q;
+    void push(int x) { q.push(x); }
+    bool pop(int& x) { return q.pop(x); }
+    bool steal(int& x) { return q.steal(x); }
+    bool empty() { return q.empty(); }
+};
+
+struct locked_queue {
+    mutex m;
+    tinySTL::deque<int> q;
+    void push(int x) { lock_guard<mutex> g(m); q.push_back(x); }
+    bool pop(int& x) {
+        lock_guard<mutex> g(m);
+        if (q.empty()) return false;
+        x = q.back();
+        q.pop_back();
+        return true;
+    }
+    bool steal(int& x) {
+        lock_guard<mutex> g(m);
+        if (q.empty()) return false;
+        x = q.front();
+        q.pop_front();
+        return true;
+    }
+    bool empty() { lock_guard<mutex> g(m); return q.empty(); }
+};
+
+static atomic<long> sink(0);
+
+template <class Queue>
+static double run(int thieves) {
+    Queue q;
+    atomic<bool> done(false);
+    vector<thread> threads;
+    for (int k = 0; k < thieves; ++k)
+        threads.push_back(thread([&] {
+            int x;
+            long sum = 0;
+            while (!done.load(memory_order_acquire) || !q.empty())
+                if (q.steal(x)) sum += x;
+            sink += sum;
+        }));
+    double t = now();
+    long sum = 0;
+    int x;
+    for (int next = 0; next < TASKS; ) {
+        for (int i = 0; i < BURST; ++i)
+            q.push(next++);
+        for (int i = 0; i < BURST / 2; ++i)
+            if (q.pop(x)) sum += x;
+    }
+    while (q.pop(x)) sum += x;
+    done.store(true, memory_order_release);
+    for (size_t k = 0; k < threads.size(); ++k)
+        threads[k].join();
+    t = now() - t;
+    sink += sum;
+    return TASKS / t / 1e6;
+}
+
+int main() {
+    printf("%8s %14s %14s\n", "thieves", "ws Mtasks/s", "mutex Mtasks/s");
+    unsigned cores = thread::hardware_concurrency();
+    for (unsigned thieves = 0; thieves < (cores > 1 ? cores : 2); thieves = thieves ? thieves * 2 : 1)
+        printf("%8u %14.1f %14.1f\n", thieves, run<ws_queue>(thieves), run<locked_queue>(thieves));
+    return sink == 0;
+}
@@ -0,0 +1,86 @@
+#include "../include/st_work_stealing_deque.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <assert.h>
+
+typedef tinySTL::work_stealing_deque<int> ws_deque;
+
+//single thread: the owner end is a stack, the thief end a queue
+void sequential () {
+    ws_deque q (2);
+    int x;
+    assert (q.empty() && !q.pop (x) && !q.steal (x));
+    for (int i = 0; i < 100; ++i)
+        q.push (i);
+    assert (q.size() == 100 && q.capacity() == 128);
+    assert (q.pop (x) && x == 99);
+    assert (q.steal (x) && x == 0);
+    assert (q.steal (x) && x == 1);
+    for (int i = 98; i >= 2; --i)
+        assert (q.pop (x) && x == i);
+    assert (q.empty() && !q.pop (x) && !q.steal (x));
+    q.release_retired ();
+    q.push (5);
+    assert (q.steal (x) && x == 5);
+}
+
+//the owner pushes bursts and pops some back while thieves steal; every
+//element has to come out exactly once
+void stress (int thieves, int items) {
+    ws_deque q (2);
+    std::vector<std::atomic<int> > seen (items);
+    for (int i = 0; i < items; ++i)
+        seen[i].store (0);
+    std::atomic<bool> done (false);
+    std::atomic<long> stolen (0);
+
+    std::vector<std::thread> threads;
+    for (int k = 0; k < thieves; ++k) {
+        threads.push_back (std::thread ([&] {
+            int x;
+            long mine = 0;
+            while (!done.load (std::memory_order_acquire) || !q.empty()) {
+                if (q.steal (x)) {
+                    seen[x].fetch_add (1, std::memory_order_relaxed);
+                    ++mine;
+                }
+            }
+            stolen += mine;
+        }));
+    }
+
+    long popped = 0;
+    int next = 0, x;
+    while (next < items) {
+        int burst = 1 + next % 37;
+        for (int i = 0; i < burst && next < items; ++i)
+            q.push (next++);
+        for (int i = 0; i < burst / 3; ++i)
+            if (q.pop (x)) {
+                seen[x].fetch_add (1, std::memory_order_relaxed);
+                ++popped;
+            }
+    }
+    while (q.pop (x)) {
+        seen[x].fetch_add (1, std::memory_order_relaxed);
+        ++popped;
+    }
+    done.store (true, std::memory_order_release);
+    for (size_t k = 0; k < threads.size(); ++k)
+        threads[k].join ();
+
+    assert (popped + stolen.load() == items);
+    for (int i = 0; i < items; ++i)
+        assert (seen[i].load() == 1);
+}
+
+int main () {
+    sequential ();
+    for (int thieves = 1; thieves <= 4; ++thieves)
+        for (int round = 0; round < 5; ++round)
+            stress (thieves, 200000);
+    std::cout << "work stealing ok" << std::endl;
+    return 0;
+}